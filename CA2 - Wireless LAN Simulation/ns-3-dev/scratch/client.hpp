@@ -1,7 +1,10 @@
 #ifndef CLIENT_HPP_INCLUDE
 #define CLIENT_HPP_INCLUDE
 
+#include <algorithm>
 #include <ctime>
+#include <cmath>
+#include <map>
 #include <vector>
 
 #include "constants.hpp"
@@ -13,72 +16,176 @@ using namespace ns3;
 
 class Client : public Application {
 public:
-    Client(uint16_t port, Ipv4InterfaceContainer& ip,
-           uint16_t masterPort, Ipv4InterfaceContainer& masterIp,
-           const std::vector<uint16_t>& data);
+    Client(uint16_t port, Ipv4InterfaceContainer& ip, unsigned idx,
+           uint16_t masterPort, Ipv4Address masterIp,
+           const std::vector<uint16_t>& data,
+           uint32_t batchSize, uint32_t window);
     virtual ~Client();
 
 private:
-    static void GenerateTraffic(Client* client, uint16_t data);
+    struct Batch {
+        Time first;
+        Time deadline;
+        uint32_t retransmissions;
+        uint8_t remaining;
+        std::vector<uint16_t> data;
+        std::vector<bool> answered;
+    };
+
+    static void GenerateTraffic(Client* client);
     static void Timeout(Client* client);
+    void SendBatch();
+    void Send(uint32_t seq, Batch& batch);
+    void ScheduleTimeout();
+    void UpdateTimeout(double rtt);
+    void Reassemble();
     void HandleRead(Ptr<Socket> socket);
     void StartApplication(void) override;
     uint16_t GetData();
 
     uint16_t port_;
     Ipv4InterfaceContainer ip_;
+    unsigned idx_;
     uint16_t masterPort_;
-    Ipv4InterfaceContainer masterIp_;
+    Ipv4Address masterIp_;
     Ptr<Socket> masterSocket_;
     Ptr<Socket> mapperSocket_;
     EventId timeoutEvent_;
     std::string dataReceived_;
     std::vector<uint16_t> data_;
     int dataIdx_ = 0;
+    uint32_t batchSize_;
+    uint32_t window_;
+    uint32_t nextSeq_ = 0;
+    uint32_t deliveredSeq_ = 0;
+    std::map<uint32_t, Batch> inFlight_;
+    std::map<uint32_t, char> reordered_;
+
+    // retransmission timeout of RFC 6298, in seconds
+    double srtt_ = 0.0;
+    double rttvar_ = 0.0;
+    double rto_ = consts::TIMEOUT;
+
+    Time startTime_;
+    Time lastReceived_;
+    double latencySum_ = 0.0;
+    uint64_t answered_ = 0;
+    uint64_t lost_ = 0;
+    uint64_t retransmitted_ = 0;
+    uint64_t duplicates_ = 0;
 };
 
-Client::Client(uint16_t port, Ipv4InterfaceContainer& ip,
-               uint16_t masterPort, Ipv4InterfaceContainer& masterIp,
-               const std::vector<uint16_t>& data)
+Client::Client(uint16_t port, Ipv4InterfaceContainer& ip, unsigned idx,
+               uint16_t masterPort, Ipv4Address masterIp,
+               const std::vector<uint16_t>& data,
+               uint32_t batchSize, uint32_t window)
     : port_(port),
       ip_(ip),
+      idx_(idx),
       masterPort_(masterPort),
       masterIp_(masterIp),
-      data_(data) {
+      data_(data),
+      batchSize_(batchSize),
+      window_(window) {
     std::srand(time(nullptr));
 }
 
+// A symbol is settled once it is answered or given up on; the ones still in
+// flight at the end are not counted.
 Client::~Client() {
-    std::cout << "Data Received: " << std::endl;
+    double duration = (lastReceived_ - startTime_).GetSeconds();
+    std::cout << "Data Received by client " << idx_ << ": " << std::endl;
     std::cout << dataReceived_ << std::endl;
+    std::cout << "Client " << idx_ << " got " << answered_ << " of " << answered_ + lost_ << " settled symbols ("
+              << (answered_ + lost_ == 0 ? 0.0 : 100.0 * answered_ / (answered_ + lost_)) << "%), "
+              << retransmitted_ << " retransmitted, " << duplicates_ << " duplicate results" << std::endl;
+    std::cout << "Client " << idx_ << " goodput: " << (duration > 0 ? answered_ / duration : 0.0) << " symbols/s, "
+              << "mean latency: " << (answered_ == 0 ? 0.0 : 1000 * latencySum_ / answered_) << " ms, "
+              << "srtt: " << 1000 * srtt_ << " ms, rto: " << 1000 * rto_ << " ms" << std::endl;
 }
 
 void Client::StartApplication(void) {
     masterSocket_ = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
-    InetSocketAddress sockAddr(masterIp_.GetAddress(0), masterPort_);
+    InetSocketAddress sockAddr(masterIp_, masterPort_);
     masterSocket_->Connect(sockAddr);
 
     mapperSocket_ = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
-    InetSocketAddress local(ip_.GetAddress(0), port_);
+    InetSocketAddress local(ip_.GetAddress(idx_), port_);
     mapperSocket_->Bind(local);
     mapperSocket_->SetRecvCallback(MakeCallback(&Client::HandleRead, this));
 
-    GenerateTraffic(this, GetData());
+    startTime_ = Simulator::Now();
+    GenerateTraffic(this);
 }
 
-void Client::GenerateTraffic(Client* client, uint16_t data) {
+// In bursty mode a batch is sent each interval. Otherwise the client keeps the
+// window full and sends a new batch when one is answered or given up on.
+void Client::GenerateTraffic(Client* client) {
+    if (consts::BURSTY_DATA) {
+        client->SendBatch();
+        Simulator::Schedule(Seconds(consts::BURSTY_DATA_SEND_INTERVAL), &Client::GenerateTraffic, client);
+        return;
+    }
+    while (client->inFlight_.size() < client->window_)
+        client->SendBatch();
+}
+
+void Client::SendBatch() {
+    Batch& batch = inFlight_[nextSeq_];
+    batch.first = Simulator::Now();
+    batch.retransmissions = 0;
+    batch.remaining = batchSize_;
+    for (uint32_t i = 0; i < batchSize_; ++i)
+        batch.data.push_back(GetData());
+    batch.answered.assign(batchSize_, false);
+
+    Send(nextSeq_, batch);
+    nextSeq_ += batchSize_;
+}
+
+// Sends the symbols of the batch that are not answered yet.
+void Client::Send(uint32_t seq, Batch& batch) {
     Ptr<Packet> packet = Create<Packet>();
     ClientHeader header;
-    header.SetData(data);
-    header.SetSource(client->ip_.GetAddress(0), client->port_);
+    header.SetSeq(seq);
+    header.SetAck(deliveredSeq_);
+    for (uint32_t i = 0; i < batch.data.size(); ++i) {
+        if (!batch.answered[i])
+            header.AddData(i, batch.data[i]);
+    }
+    header.SetSource(ip_.GetAddress(idx_), port_);
 
     packet->AddHeader(header);
-    client->masterSocket_->Send(packet);
+    masterSocket_->Send(packet);
+
+    // After UpdateTimeout lowers rto_, this deadline can be earlier than the
+    // pending timeout.
+    batch.deadline = Simulator::Now() + Seconds(rto_);
+    if (!timeoutEvent_.IsRunning() || batch.deadline < Simulator::Now() + Simulator::GetDelayLeft(timeoutEvent_))
+        ScheduleTimeout();
+}
+
+void Client::ScheduleTimeout() {
+    Simulator::Cancel(timeoutEvent_);
+    if (inFlight_.empty())
+        return;
+    Time deadline = inFlight_.begin()->second.deadline;
+    for (const auto& batch : inFlight_)
+        deadline = std::min(deadline, batch.second.deadline);
+    timeoutEvent_ = Simulator::Schedule(deadline - Simulator::Now(), &Client::Timeout, this);
+}
 
-    if (consts::BURSTY_DATA)
-        Simulator::Schedule(Seconds(consts::BURSTY_DATA_SEND_INTERVAL), &Client::GenerateTraffic, client, client->GetData());
-    else
-        client->timeoutEvent_ = Simulator::Schedule(Seconds(consts::TIMEOUT), &Client::Timeout, client);
+// Only the batches answered without a retransmission give a sample (Karn's algorithm).
+void Client::UpdateTimeout(double rtt) {
+    if (srtt_ == 0.0) {
+        srtt_ = rtt;
+        rttvar_ = rtt / 2;
+    }
+    else {
+        rttvar_ = 0.75 * rttvar_ + 0.25 * std::abs(srtt_ - rtt);
+        srtt_ = 0.875 * srtt_ + 0.125 * rtt;
+    }
+    rto_ = std::min(std::max(srtt_ + 4 * rttvar_, consts::MIN_TIMEOUT), consts::MAX_TIMEOUT);
 }
 
 uint16_t Client::GetData() {
@@ -91,6 +198,7 @@ uint16_t Client::GetData() {
 
 void Client::HandleRead(Ptr<Socket> socket) {
     Ptr<Packet> packet;
+    Time now = Simulator::Now();
 
     while (packet = socket->Recv()) {
         if (packet->GetSize() == 0) {
@@ -100,20 +208,84 @@ void Client::HandleRead(Ptr<Socket> socket) {
         MapperHeader header;
         packet->RemoveHeader(header);
 
-        dataReceived_ += header.GetData();
-        std::cout << "Received: " << header.GetData() << std::endl;
-        // header.Print(std::cout);
+        // The parts of a batch come from different mappers. Results that were
+        // already received, or of batches that were given up on, are dropped.
+        auto it = inFlight_.find(header.GetSeq());
+        if (it == inFlight_.end()) {
+            duplicates_ += header.GetCount();
+            continue;
+        }
+        Batch& batch = it->second;
+        for (uint8_t i = 0; i < header.GetCount(); ++i) {
+            uint8_t offset = header.GetOffset(i);
+            if (offset >= batch.answered.size() || batch.answered[offset]) {
+                ++duplicates_;
+                continue;
+            }
+            batch.answered[offset] = true;
+            --batch.remaining;
+            ++answered_;
+            latencySum_ += (now - batch.first).GetSeconds();
+            reordered_[header.GetSeq() + offset] = header.GetData(i);
+            std::cout << "Received: " << header.GetData(i) << std::endl;
+        }
+        lastReceived_ = now;
+        if (batch.remaining == 0) {
+            if (batch.retransmissions == 0)
+                UpdateTimeout((now - batch.first).GetSeconds());
+            inFlight_.erase(it);
+        }
     }
 
-    if (!consts::BURSTY_DATA) {
-        Simulator::Cancel(timeoutEvent_);
-        GenerateTraffic(this, GetData());
+    Reassemble();
+    if (!consts::BURSTY_DATA)
+        GenerateTraffic(this);
+}
+
+// The symbols before the oldest batch in flight are all in or lost, so they
+// are added even with gaps. After it only the consecutive ones are added.
+void Client::Reassemble() {
+    uint32_t settledSeq = inFlight_.empty() ? nextSeq_ : inFlight_.begin()->first;
+    for (auto it = reordered_.begin(); it != reordered_.end() && it->first < settledSeq; it = reordered_.erase(it))
+        dataReceived_ += it->second;
+    deliveredSeq_ = std::max(deliveredSeq_, settledSeq);
+    for (auto it = reordered_.begin(); it != reordered_.end() && it->first == deliveredSeq_; it = reordered_.erase(it)) {
+        dataReceived_ += it->second;
+        ++deliveredSeq_;
     }
 }
 
+// The timeout is doubled, and the unanswered symbols of the expired batches
+// are sent again. After MAX_RETRANSMISSIONS a batch is given up on.
 void Client::Timeout(Client* client) {
-    // std::cout << "Timed out waiting for response at " << Simulator::Now().GetSeconds() << std::endl;
-    GenerateTraffic(client, client->GetData());
+    Time now = Simulator::Now();
+    bool expired = false;
+    for (const auto& batch : client->inFlight_)
+        expired = expired || batch.second.deadline <= now;
+    if (expired)
+        client->rto_ = std::min(2 * client->rto_, consts::MAX_TIMEOUT);
+
+    for (auto it = client->inFlight_.begin(); it != client->inFlight_.end();) {
+        Batch& batch = it->second;
+        if (batch.deadline > now) {
+            ++it;
+            continue;
+        }
+        if (batch.retransmissions == consts::MAX_RETRANSMISSIONS) {
+            client->lost_ += batch.remaining;
+            it = client->inFlight_.erase(it);
+            continue;
+        }
+        ++batch.retransmissions;
+        client->retransmitted_ += batch.remaining;
+        client->Send(it->first, batch);
+        ++it;
+    }
+
+    client->Reassemble();
+    if (!consts::BURSTY_DATA)
+        GenerateTraffic(client);
+    client->ScheduleTimeout();
 }
 
 #endif // CLIENT_HPP_INCLUDE
@@ -8,39 +8,66 @@
 namespace consts {
 
 // header
-constexpr uint32_t CLIENT_HEADER_LENGTH = 8;
-constexpr uint32_t MAPPER_HEADER_LENGTH = 1;
+constexpr uint32_t CLIENT_HEADER_LENGTH = 15; // without the symbols
+constexpr uint32_t CLIENT_SYMBOL_LENGTH = 3;
+constexpr uint32_t MAPPER_HEADER_LENGTH = 5;
+constexpr uint32_t MAPPER_SYMBOL_LENGTH = 2;
+constexpr uint32_t MAX_BATCH_SIZE = 255;
 
 // client
 constexpr uint16_t CLIENT_PORT = 1102;
+constexpr uint32_t BATCH_SIZE = 32;  // symbols in a request, default of --batch
+constexpr uint32_t WINDOW_SIZE = 2;  // batches in flight, default of --window
 
 // master
 constexpr uint16_t MASTER_PORT = 1102;
 
 // mappers
+constexpr uint16_t MAPPER_PORT = 1102;
+
+// reducers
+constexpr uint16_t REDUCER_PORT = 1102;
+
+// topology defaults, overridden from the command line
+constexpr uint32_t CLIENTS_COUNT = 1;
 constexpr uint32_t MAPPERS_COUNT = 3;
-const std::array<uint16_t, MAPPERS_COUNT> MAPPER_PORTS = {1102, 1102, 1102};
+constexpr uint32_t REDUCERS_COUNT = 0;
+constexpr uint32_t ACCESS_POINTS_COUNT = 1;
 
 // network
 const std::string SSID = "ns-3-ssid";
-const char* BASE_ADDRESS = "10.1.3.0";
-const char* NET_MASK = "255.255.255.0";
+const char* BASE_ADDRESS = "10.1.0.0"; // BSS i uses 10.(1 + i).0.0
+const char* NET_MASK = "255.255.0.0";
+// 20 MHz 802.11a channels that do not overlap, assigned to the BSSs in turn
+const std::array<uint8_t, 8> CHANNELS = {36, 40, 44, 48, 52, 56, 60, 64};
+constexpr double ARP_DEAD_TIMEOUT = 1.0;
 
 // simulation
 constexpr double DURATION = 10.0;
 constexpr double SIMULATION_DURATION = DURATION;
+constexpr double MASTER_START_TIME = 0.5;
+constexpr double CLIENT_START_TIME = 1.0;
 constexpr double MONITOR_TIME_INTERVAL = 1.0;
-constexpr double TIMEOUT = 0.1;
+constexpr double MONITOR_BIN_WIDTH = 0.0001; // s, of the delay and jitter histograms
+constexpr uint32_t MONITOR_BUFFER_SIZE = 1 << 16; // bytes buffered before a write to the file
+const std::string MONITOR_FILE = "flows.csv"; // default of --monitor
+constexpr double TIMEOUT = 0.1; // initial retransmission timeout of the client
+constexpr double MIN_TIMEOUT = 0.02;
+constexpr double MAX_TIMEOUT = 1.0;
+constexpr uint32_t MAX_RETRANSMISSIONS = 8; // of a batch, before the client gives up on it
 constexpr double BURSTY_DATA_SEND_INTERVAL = 0.001;
 constexpr double DELTA_X = 5.0;
 constexpr double DELTA_Y = 10.0;
 constexpr uint32_t GRID_WIDTH = 3;
+constexpr double WALK_BOUND = 50.0;            // m, clients walk in [-WALK_BOUND, WALK_BOUND] on both axes
+constexpr double MAX_GRID_SIZE = WALK_BOUND;   // m, side of the grid of many stations, inside the walk bounds
 constexpr bool VERBOSE_DEFAULT = true;
 
 // data
 constexpr bool RANDOM_DATA = false;
 constexpr bool BURSTY_DATA = false;
 constexpr bool SHUFFLE_MAPPINGS = false;
+constexpr bool BROADCAST_REQUESTS = false; // default of --broadcast
 const std::string VALID_CHARACTERS = RANDOM_DATA ? "abcdefghijklmnopqrstuvwxyz"
                                                  : "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
                                                    "abcdefghijklmnopqrstuvwxyz"
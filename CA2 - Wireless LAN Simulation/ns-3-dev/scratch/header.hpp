@@ -1,12 +1,19 @@
 #ifndef HEADER_HPP_INCLUDE
 #define HEADER_HPP_INCLUDE
 
+#include <utility>
+#include <vector>
+
 #include "constants.hpp"
+#include "ns3/packet.h"
 #include "ns3/udp-header.h"
 #include "ns3/yans-wifi-helper.h"
 
 using namespace ns3;
 
+// A batch of symbols. Symbol i of the batch has the sequence number
+// seq + offset(i), so a part of a batch keeps the place of its symbols.
+// The client has all of its results before ack, or has given up on them.
 class ClientHeader : public Header {
 public:
     ClientHeader() = default;
@@ -14,11 +21,18 @@ public:
 
     static TypeId GetTypeId(void);
     TypeId GetInstanceTypeId(void) const override;
+    static uint32_t PeekSerializedSize(Ptr<const Packet> packet);
 
-    void SetData(uint16_t data);
+    void SetSeq(uint32_t seq);
+    void SetAck(uint32_t ack);
+    void AddData(uint8_t offset, uint16_t data);
     void SetSource(Ipv4Address ip, uint16_t port);
 
-    uint16_t GetData(void) const;
+    uint32_t GetSeq(void) const;
+    uint32_t GetAck(void) const;
+    uint8_t GetCount(void) const;
+    uint8_t GetOffset(uint8_t idx) const;
+    uint16_t GetData(uint8_t idx) const;
     Ipv4Address GetSourceIP(void) const;
     uint16_t GetSourcePort(void) const;
 
@@ -28,10 +42,12 @@ public:
     uint32_t GetSerializedSize(void) const override;
 
 private:
-    uint16_t mData_;
+    uint32_t mSeq_ = 0;
+    uint32_t mAck_ = 0;
+    std::vector<std::pair<uint8_t, uint16_t>> mData_;
 
     Ipv4Address mSourceIP_;
-    uint16_t mSourcePort_;
+    uint16_t mSourcePort_ = 0;
 };
 
 TypeId ClientHeader::GetTypeId(void) {
@@ -43,8 +59,26 @@ TypeId ClientHeader::GetInstanceTypeId(void) const {
     return GetTypeId();
 }
 
-void ClientHeader::SetData(uint16_t data) {
-    mData_ = data;
+// Size of the header at the start of the packet, or 0 if its fixed part is not there yet.
+uint32_t ClientHeader::PeekSerializedSize(Ptr<const Packet> packet) {
+    uint8_t fixed[consts::CLIENT_HEADER_LENGTH];
+    if (packet->GetSize() < consts::CLIENT_HEADER_LENGTH) {
+        return 0;
+    }
+    packet->CopyData(fixed, consts::CLIENT_HEADER_LENGTH);
+    return consts::CLIENT_HEADER_LENGTH + fixed[consts::CLIENT_HEADER_LENGTH - 1] * consts::CLIENT_SYMBOL_LENGTH;
+}
+
+void ClientHeader::SetSeq(uint32_t seq) {
+    mSeq_ = seq;
+}
+
+void ClientHeader::SetAck(uint32_t ack) {
+    mAck_ = ack;
+}
+
+void ClientHeader::AddData(uint8_t offset, uint16_t data) {
+    mData_.emplace_back(offset, data);
 }
 
 void ClientHeader::SetSource(Ipv4Address ip, uint16_t port) {
@@ -52,6 +86,26 @@ void ClientHeader::SetSource(Ipv4Address ip, uint16_t port) {
     mSourcePort_ = port;
 }
 
+uint32_t ClientHeader::GetSeq(void) const {
+    return mSeq_;
+}
+
+uint32_t ClientHeader::GetAck(void) const {
+    return mAck_;
+}
+
+uint8_t ClientHeader::GetCount(void) const {
+    return mData_.size();
+}
+
+uint8_t ClientHeader::GetOffset(uint8_t idx) const {
+    return mData_[idx].first;
+}
+
+uint16_t ClientHeader::GetData(uint8_t idx) const {
+    return mData_[idx].second;
+}
+
 Ipv4Address ClientHeader::GetSourceIP(void) const {
     return mSourceIP_;
 }
@@ -60,31 +114,45 @@ uint16_t ClientHeader::GetSourcePort(void) const {
     return mSourcePort_;
 }
 
-uint16_t ClientHeader::GetData(void) const {
-    return mData_;
-}
-
 void ClientHeader::Print(std::ostream& os) const {
-    os << "data = " << mData_ << std::endl;
+    os << "seq = " << mSeq_ << ", ack = " << mAck_ << ", data =";
+    for (const auto& data : mData_) {
+        os << " " << data.second;
+    }
+    os << std::endl;
 }
 
+// The count is the last byte of the fixed part, which PeekSerializedSize relies on.
 void ClientHeader::Serialize(Buffer::Iterator start) const {
-    start.WriteHtonU16(mData_);
+    start.WriteHtonU32(mSeq_);
+    start.WriteHtonU32(mAck_);
     start.WriteHtonU32(mSourceIP_.Get());
     start.WriteHtonU16(mSourcePort_);
+    start.WriteU8(mData_.size());
+    for (const auto& data : mData_) {
+        start.WriteU8(data.first);
+        start.WriteHtonU16(data.second);
+    }
 }
 
 uint32_t ClientHeader::Deserialize(Buffer::Iterator start) {
-    mData_ = start.ReadNtohU16();
+    mSeq_ = start.ReadNtohU32();
+    mAck_ = start.ReadNtohU32();
     mSourceIP_.Set(start.ReadNtohU32());
     mSourcePort_ = start.ReadNtohU16();
-    return consts::CLIENT_HEADER_LENGTH;
+    mData_.resize(start.ReadU8());
+    for (auto& data : mData_) {
+        data.first = start.ReadU8();
+        data.second = start.ReadNtohU16();
+    }
+    return GetSerializedSize();
 }
 
 uint32_t ClientHeader::GetSerializedSize(void) const {
-    return consts::CLIENT_HEADER_LENGTH;
+    return consts::CLIENT_HEADER_LENGTH + mData_.size() * consts::CLIENT_SYMBOL_LENGTH;
 }
 
+// The mapped symbols of a batch, with the same sequence number and offsets as in its ClientHeader.
 class MapperHeader : public Header {
 public:
     MapperHeader() = default;
@@ -93,8 +161,13 @@ public:
     static TypeId GetTypeId(void);
     TypeId GetInstanceTypeId(void) const override;
 
-    void SetData(char data);
-    char GetData(void) const;
+    void SetSeq(uint32_t seq);
+    void AddData(uint8_t offset, char data);
+
+    uint32_t GetSeq(void) const;
+    uint8_t GetCount(void) const;
+    uint8_t GetOffset(uint8_t idx) const;
+    char GetData(uint8_t idx) const;
 
     void Print(std::ostream& os) const override;
     void Serialize(Buffer::Iterator start) const override;
@@ -102,7 +175,8 @@ public:
     uint32_t GetSerializedSize(void) const override;
 
 private:
-    char mData_;
+    uint32_t mSeq_ = 0;
+    std::vector<std::pair<uint8_t, char>> mData_;
 };
 
 TypeId MapperHeader::GetTypeId(void) {
@@ -114,29 +188,58 @@ TypeId MapperHeader::GetInstanceTypeId(void) const {
     return GetTypeId();
 }
 
-void MapperHeader::SetData(char data) {
-    mData_ = data;
+void MapperHeader::SetSeq(uint32_t seq) {
+    mSeq_ = seq;
+}
+
+void MapperHeader::AddData(uint8_t offset, char data) {
+    mData_.emplace_back(offset, data);
+}
+
+uint32_t MapperHeader::GetSeq(void) const {
+    return mSeq_;
+}
+
+uint8_t MapperHeader::GetCount(void) const {
+    return mData_.size();
+}
+
+uint8_t MapperHeader::GetOffset(uint8_t idx) const {
+    return mData_[idx].first;
 }
 
-char MapperHeader::GetData(void) const {
-    return mData_;
+char MapperHeader::GetData(uint8_t idx) const {
+    return mData_[idx].second;
 }
 
 void MapperHeader::Print(std::ostream& os) const {
-    os << mData_ << std::endl;
+    for (const auto& data : mData_) {
+        os << data.second;
+    }
+    os << std::endl;
 }
 
 void MapperHeader::Serialize(Buffer::Iterator start) const {
-    start.WriteU8(mData_);
+    start.WriteHtonU32(mSeq_);
+    start.WriteU8(mData_.size());
+    for (const auto& data : mData_) {
+        start.WriteU8(data.first);
+        start.WriteU8(data.second);
+    }
 }
 
 uint32_t MapperHeader::Deserialize(Buffer::Iterator start) {
-    mData_ = start.ReadU8();
-    return consts::MAPPER_HEADER_LENGTH;
+    mSeq_ = start.ReadNtohU32();
+    mData_.resize(start.ReadU8());
+    for (auto& data : mData_) {
+        data.first = start.ReadU8();
+        data.second = start.ReadU8();
+    }
+    return GetSerializedSize();
 }
 
 uint32_t MapperHeader::GetSerializedSize(void) const {
-    return consts::MAPPER_HEADER_LENGTH;
+    return consts::MAPPER_HEADER_LENGTH + mData_.size() * consts::MAPPER_SYMBOL_LENGTH;
 }
 
 #endif // HEADER_HPP_INCLUDE
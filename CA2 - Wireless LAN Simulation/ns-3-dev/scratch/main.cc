@@ -5,18 +5,41 @@
 
 int main(int argc, char* argv[]) {
     bool verbose = consts::VERBOSE_DEFAULT;
+    Topology topology;
+    Pipeline pipeline;
+    std::string monitorFile = consts::MONITOR_FILE;
     CommandLine cmd(__FILE__);
     cmd.AddValue("verbose", "Tell echo applications to log if true", verbose);
+    cmd.AddValue("clients", "Number of clients", topology.clients);
+    cmd.AddValue("mappers", "Number of mappers, the characters are partitioned between them", topology.mappers);
+    cmd.AddValue("reducers", "Number of reducers between the mappers and the clients, 0 for none", topology.reducers);
+    cmd.AddValue("aps", "Number of BSSs, each with an access point of the master on its own channel", topology.accessPoints);
+    cmd.AddValue("broadcast", "Send every request to all the mappers instead of only the one with its mapping", pipeline.broadcast);
+    cmd.AddValue("batch", "Number of symbols in a request", pipeline.batchSize);
+    cmd.AddValue("window", "Number of requests the client keeps in flight", pipeline.window);
+    cmd.AddValue("monitor", "CSV file of the flow statistics of each interval, none for no file", monitorFile);
     cmd.Parse(argc, argv);
 
+    if (topology.clients == 0 || topology.mappers == 0 || topology.accessPoints == 0 || topology.accessPoints > 255) {
+        std::cerr << "clients, mappers and aps must be positive, and aps at most 255" << std::endl;
+        return 1;
+    }
+    if (pipeline.batchSize == 0 || pipeline.batchSize > consts::MAX_BATCH_SIZE || pipeline.window == 0) {
+        std::cerr << "batch must be between 1 and " << consts::MAX_BATCH_SIZE << ", and window positive" << std::endl;
+        return 1;
+    }
+
+    if (monitorFile == "none")
+        monitorFile.clear();
+
     std::string chars = consts::VALID_CHARACTERS;
     if (consts::SHUFFLE_MAPPINGS)
         chars = utils::shuffle(chars);
     auto clientSendData = utils::reverseMap(chars, consts::MESSAGE);
-    auto mappings = utils::partitionMappings(chars, consts::MAPPERS_COUNT);
+    auto mappings = utils::partitionMappings(chars, topology.mappers);
 
-    Network net(verbose, clientSendData, mappings);
-    net.Simulate();
+    Network net(verbose, topology, pipeline, clientSendData, mappings);
+    net.Simulate(monitorFile);
 
     return 0;
 }
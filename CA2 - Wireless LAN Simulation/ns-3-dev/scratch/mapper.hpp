@@ -1,9 +1,13 @@
 #ifndef MAPPER_HPP_INCLUDE
 #define MAPPER_HPP_INCLUDE
 
+#include <map>
+#include <set>
 #include <unordered_map>
+#include <utility>
 
 #include "header.hpp"
+#include "utils.hpp"
 #include "ns3/applications-module.h"
 #include "ns3/internet-module.h"
 
@@ -11,12 +15,13 @@ using namespace ns3;
 
 class Mapper : public Application {
 public:
-    Mapper(uint16_t port, Ipv4InterfaceContainer& ip, unsigned idx, const std::unordered_map<uint16_t, char>& map);
-    virtual ~Mapper() = default;
+    Mapper(uint16_t port, Ipv4InterfaceContainer& ip, unsigned idx, const std::unordered_map<uint16_t, char>& map,
+           uint16_t reducerPort, Ipv4InterfaceContainer& reducerIps);
+    virtual ~Mapper();
 
 private:
     void StartApplication(void) override;
-    void SendMappedData(char data, Ipv4Address ip, uint16_t port);
+    void SendMappedData(const MapperHeader& mapped, Ipv4Address ip, uint16_t port, bool reduce);
     char Map(uint16_t data) const;
     void HandleRead(Ptr<Socket> socket);
     void HandleAccept(Ptr<Socket> socket, const Address& from);
@@ -25,15 +30,29 @@ private:
     Ipv4InterfaceContainer ip_;
     Ptr<Socket> socket_;
     Ptr<Socket> clientSocket_;
+    Ptr<Packet> stream_ = Create<Packet>();
     unsigned idx_;
     std::unordered_map<uint16_t, char> map_;
+    uint16_t reducerPort_;
+    Ipv4InterfaceContainer reducerIps_;
+    // sequence numbers of the symbols answered to each client ip:port
+    std::map<std::pair<uint32_t, uint16_t>, std::set<uint32_t>> answered_;
+    uint64_t mapped_ = 0;
+    uint64_t duplicates_ = 0;
 };
 
-Mapper::Mapper(uint16_t port, Ipv4InterfaceContainer& ip, unsigned idx, const std::unordered_map<uint16_t, char>& map)
+Mapper::Mapper(uint16_t port, Ipv4InterfaceContainer& ip, unsigned idx, const std::unordered_map<uint16_t, char>& map,
+               uint16_t reducerPort, Ipv4InterfaceContainer& reducerIps)
     : port_(port),
       ip_(ip),
       idx_(idx),
-      map_(map) {}
+      map_(map),
+      reducerPort_(reducerPort),
+      reducerIps_(reducerIps) {}
+
+Mapper::~Mapper() {
+    std::cout << "Mapper " << idx_ << " mapped " << mapped_ << " symbols, " << duplicates_ << " duplicates" << std::endl;
+}
 
 void Mapper::StartApplication(void) {
     socket_ = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
@@ -46,15 +65,30 @@ void Mapper::StartApplication(void) {
     clientSocket_ = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
 }
 
-void Mapper::SendMappedData(char data, Ipv4Address ip, uint16_t port) {
-    MapperHeader header;
-    header.SetData(data);
-
+// Without reducers the result goes straight to the client. Otherwise it goes to
+// the reducer of the client, with the client's address for the reducer to reply to.
+// Results that the reducer has already counted are not reduced again.
+void Mapper::SendMappedData(const MapperHeader& mapped, Ipv4Address ip, uint16_t port, bool reduce) {
     Ptr<Packet> packet = Create<Packet>();
+
+    if (!reduce || reducerIps_.GetN() == 0) {
+        packet->AddHeader(mapped);
+
+        InetSocketAddress destination(ip, port);
+        clientSocket_->SendTo(packet, 0, destination);
+        return;
+    }
+
+    ClientHeader header;
+    header.SetSeq(mapped.GetSeq());
+    for (uint8_t i = 0; i < mapped.GetCount(); ++i) {
+        header.AddData(mapped.GetOffset(i), static_cast<uint8_t>(mapped.GetData(i)));
+    }
+    header.SetSource(ip, port);
     packet->AddHeader(header);
 
-    InetSocketAddress destination(ip, port);
-    clientSocket_->SendTo(packet, 0, destination);
+    InetSocketAddress reducer(reducerIps_.GetAddress(utils::reducerOf(ip, reducerIps_.GetN())), reducerPort_);
+    clientSocket_->SendTo(packet, 0, reducer);
 }
 
 char Mapper::Map(uint16_t data) const {
@@ -64,6 +98,8 @@ char Mapper::Map(uint16_t data) const {
     return 0;
 }
 
+// TCP merges and splits the batches of the master, so they are taken from the
+// received stream once they are complete.
 void Mapper::HandleRead(Ptr<Socket> socket) {
     Ptr<Packet> packet;
 
@@ -71,17 +107,40 @@ void Mapper::HandleRead(Ptr<Socket> socket) {
         if (packet->GetSize() == 0) {
             break;
         }
+        stream_->AddAtEnd(packet);
+    }
 
+    uint32_t size;
+    while ((size = ClientHeader::PeekSerializedSize(stream_)) != 0 && stream_->GetSize() >= size) {
         ClientHeader header;
-        packet->RemoveHeader(header);
-
-        Ipv4Address src = header.GetSourceIP();
-        uint16_t srcPort = header.GetSourcePort();
-        uint16_t data = header.GetData();
-
-        char mappedData = Map(data);
-        if (mappedData != 0)
-            SendMappedData(mappedData, src, srcPort);
+        stream_->RemoveHeader(header);
+
+        // A request for a symbol that was already answered is a retransmission
+        // of the client, so its result was lost and is only sent again. The
+        // client has settled everything before the ack, which is forgotten.
+        auto& answered = answered_[{header.GetSourceIP().Get(), header.GetSourcePort()}];
+        answered.erase(answered.begin(), answered.lower_bound(header.GetAck()));
+
+        MapperHeader mapped, repeated;
+        mapped.SetSeq(header.GetSeq());
+        repeated.SetSeq(header.GetSeq());
+        for (uint8_t i = 0; i < header.GetCount(); ++i) {
+            char mappedData = Map(header.GetData(i));
+            if (mappedData == 0)
+                continue;
+            if (answered.insert(header.GetSeq() + header.GetOffset(i)).second) {
+                ++mapped_;
+                mapped.AddData(header.GetOffset(i), mappedData);
+            }
+            else {
+                ++duplicates_;
+                repeated.AddData(header.GetOffset(i), mappedData);
+            }
+        }
+        if (mapped.GetCount() != 0)
+            SendMappedData(mapped, header.GetSourceIP(), header.GetSourcePort(), true);
+        if (repeated.GetCount() != 0)
+            SendMappedData(repeated, header.GetSourceIP(), header.GetSourcePort(), false);
     }
 }
 
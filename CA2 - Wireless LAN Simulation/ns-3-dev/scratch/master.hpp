@@ -1,10 +1,11 @@
 #ifndef MASTER_HPP_INCLUDE
 #define MASTER_HPP_INCLUDE
 
-#include <array>
 #include <ctime>
+#include <vector>
 
 #include "header.hpp"
+#include "utils.hpp"
 #include "ns3/applications-module.h"
 #include "ns3/internet-module.h"
 
@@ -13,7 +14,8 @@ using namespace ns3;
 class Master : public Application {
 public:
     Master(uint16_t port, Ipv4InterfaceContainer& ip,
-           std::array<uint16_t, consts::MAPPERS_COUNT> mapperPorts, Ipv4InterfaceContainer& mapperIps);
+           uint16_t mapperPort, Ipv4InterfaceContainer& mapperIps,
+           size_t charCount, bool broadcast);
     virtual ~Master() = default;
 
 private:
@@ -23,31 +25,38 @@ private:
 
     uint16_t port_;
     Ipv4InterfaceContainer ip_;
-    std::array<uint16_t, consts::MAPPERS_COUNT> mapperPorts_;
+    uint16_t mapperPort_;
     Ipv4InterfaceContainer mapperIps_;
+    size_t charCount_;
+    bool broadcast_;
     Ptr<Socket> socket_;
-    std::array<Ptr<Socket>, consts::MAPPERS_COUNT> mapperSockets_;
+    std::vector<Ptr<Socket>> mapperSockets_;
 };
 
 Master::Master(uint16_t port, Ipv4InterfaceContainer& ip,
-               std::array<uint16_t, consts::MAPPERS_COUNT> mapperPorts, Ipv4InterfaceContainer& mapperIps)
+               uint16_t mapperPort, Ipv4InterfaceContainer& mapperIps,
+               size_t charCount, bool broadcast)
     : port_(port),
       ip_(ip),
-      mapperPorts_(mapperPorts),
-      mapperIps_(mapperIps) {
+      mapperPort_(mapperPort),
+      mapperIps_(mapperIps),
+      charCount_(charCount),
+      broadcast_(broadcast) {
     std::srand(time(nullptr));
 }
 
 void Master::StartApplication(void) {
     socket_ = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
-    InetSocketAddress local(ip_.GetAddress(0), port_);
+    // The master is the access point of every BSS, so it listens on all of its interfaces.
+    InetSocketAddress local(Ipv4Address::GetAny(), port_);
     socket_->Bind(local);
 
-    for (unsigned i = 0; i < mapperPorts_.size(); ++i) {
+    mapperSockets_.reserve(mapperIps_.GetN());
+    for (unsigned i = 0; i < mapperIps_.GetN(); ++i) {
         Ptr<Socket> mapperSocket = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
-        InetSocketAddress mapper(mapperIps_.GetAddress(i), mapperPorts_[i]);
+        InetSocketAddress mapper(mapperIps_.GetAddress(i), mapperPort_);
         mapperSocket->Connect(mapper);
-        mapperSockets_[i] = mapperSocket;
+        mapperSockets_.push_back(mapperSocket);
     }
 
     socket_->SetRecvCallback(MakeCallback(&Master::HandleRead, this));
@@ -68,12 +77,38 @@ void Master::HandleRead(Ptr<Socket> socket) {
     }
 }
 
+// Each character is mapped by a single mapper, the one with its partition in
+// utils::partitionMappings, so a batch is split into one part per mapper unless
+// broadcasting is asked for. The parts keep the sequence number and offsets.
 void Master::ForwardHeader(ClientHeader header) {
-    Ptr<Packet> packet = Create<Packet>();
-    packet->AddHeader(header);
+    if (broadcast_) {
+        Ptr<Packet> packet = Create<Packet>();
+        packet->AddHeader(header);
+        for (auto& socket : mapperSockets_) {
+            socket->Send(packet);
+        }
+        return;
+    }
+
+    std::vector<ClientHeader> parts(mapperSockets_.size());
+    for (uint8_t i = 0; i < header.GetCount(); ++i) {
+        uint16_t data = header.GetData(i);
+        if (data >= charCount_) {
+            continue;
+        }
+        parts[utils::partitionOf(data, charCount_, parts.size())].AddData(header.GetOffset(i), data);
+    }
 
-    for (auto& socket : mapperSockets_) {
-        socket->Send(packet);
+    for (unsigned i = 0; i < parts.size(); ++i) {
+        if (parts[i].GetCount() == 0) {
+            continue;
+        }
+        parts[i].SetSeq(header.GetSeq());
+        parts[i].SetAck(header.GetAck());
+        parts[i].SetSource(header.GetSourceIP(), header.GetSourcePort());
+        Ptr<Packet> packet = Create<Packet>();
+        packet->AddHeader(parts[i]);
+        mapperSockets_[i]->Send(packet);
     }
 }
 
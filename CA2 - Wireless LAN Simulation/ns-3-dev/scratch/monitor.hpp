@@ -0,0 +1,171 @@
+#ifndef MONITOR_HPP_INCLUDE
+#define MONITOR_HPP_INCLUDE
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "constants.hpp"
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+
+using namespace ns3;
+
+// Writes a CSV row for each flow that changed in each interval, with the
+// throughput, delay and jitter of the packets received in that interval only.
+// The delay and jitter percentiles come from the difference of the histograms
+// of the flow monitor since the previous interval.
+class IntervalMonitor {
+public:
+    IntervalMonitor(Ptr<FlowMonitor> flowMonitor, Ptr<Ipv4FlowClassifier> classifier, const std::string& path);
+    ~IntervalMonitor();
+
+    void Start();
+    // Writes the rows of the interval that the end of the simulation cut
+    // short, since Simulator::Stop runs before a report due at the same time.
+    void Finish();
+
+private:
+    struct Snapshot {
+        uint32_t txPackets = 0;
+        uint32_t rxPackets = 0;
+        uint32_t lostPackets = 0;
+        uint64_t rxBytes = 0;
+        Time delaySum;
+        Time jitterSum;
+        std::vector<uint32_t> delayBins;
+        std::vector<uint32_t> jitterBins;
+    };
+
+    static void Report(IntervalMonitor* monitor);
+    void WriteRows();
+    static std::vector<uint32_t> GetBins(const Histogram& histogram);
+    static std::array<double, 3> GetPercentiles(const std::vector<uint32_t>& bins, const std::vector<uint32_t>& previous);
+
+    Ptr<FlowMonitor> flowMonitor_;
+    Ptr<Ipv4FlowClassifier> classifier_;
+    std::vector<char> buffer_;
+    std::ofstream file_;
+    std::unordered_map<FlowId, Snapshot> previous_;
+    Time lastReport_;
+};
+
+IntervalMonitor::IntervalMonitor(Ptr<FlowMonitor> flowMonitor, Ptr<Ipv4FlowClassifier> classifier, const std::string& path)
+    : flowMonitor_(flowMonitor),
+      classifier_(classifier),
+      buffer_(consts::MONITOR_BUFFER_SIZE) {
+    flowMonitor_->SetAttribute("DelayBinWidth", DoubleValue(consts::MONITOR_BIN_WIDTH));
+    flowMonitor_->SetAttribute("JitterBinWidth", DoubleValue(consts::MONITOR_BIN_WIDTH));
+    file_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+    file_.open(path);
+    file_ << "time,flow,source,destination,tx_packets,rx_packets,lost_packets,throughput_mbps,"
+             "delay_mean_ms,delay_p50_ms,delay_p95_ms,delay_p99_ms,"
+             "jitter_mean_ms,jitter_p50_ms,jitter_p95_ms,jitter_p99_ms\n";
+}
+
+IntervalMonitor::~IntervalMonitor() {
+    file_.flush();
+}
+
+void IntervalMonitor::Start() {
+    Simulator::Schedule(Seconds(consts::MONITOR_TIME_INTERVAL), &IntervalMonitor::Report, this);
+}
+
+void IntervalMonitor::Finish() {
+    if (Simulator::Now() > lastReport_) {
+        WriteRows();
+    }
+}
+
+// GetBinCount is not const in ns-3.35, although it only reads the bin.
+std::vector<uint32_t> IntervalMonitor::GetBins(const Histogram& histogram) {
+    std::vector<uint32_t> bins(histogram.GetNBins());
+    for (uint32_t i = 0; i < bins.size(); ++i) {
+        bins[i] = const_cast<Histogram&>(histogram).GetBinCount(i);
+    }
+    return bins;
+}
+
+// 50th, 95th and 99th percentiles in ms of the values added since the
+// previous bins, as the middle of their bins.
+std::array<double, 3> IntervalMonitor::GetPercentiles(const std::vector<uint32_t>& bins, const std::vector<uint32_t>& previous) {
+    std::vector<uint32_t> added(bins.size());
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < bins.size(); ++i) {
+        added[i] = bins[i] - (i < previous.size() ? previous[i] : 0);
+        total += added[i];
+    }
+
+    std::array<double, 3> ranks = {0.50, 0.95, 0.99};
+    std::array<double, 3> result = {0.0, 0.0, 0.0};
+    uint64_t count = 0;
+    unsigned next = 0;
+    for (uint32_t i = 0; i < added.size() && next < ranks.size() && total != 0; ++i) {
+        count += added[i];
+        while (next < ranks.size() && count >= ranks[next] * total) {
+            result[next++] = (i + 0.5) * consts::MONITOR_BIN_WIDTH * 1000;
+        }
+    }
+    return result;
+}
+
+void IntervalMonitor::Report(IntervalMonitor* monitor) {
+    monitor->WriteRows();
+    Simulator::Schedule(Seconds(consts::MONITOR_TIME_INTERVAL), &Report, monitor);
+}
+
+void IntervalMonitor::WriteRows() {
+    double now = Simulator::Now().GetSeconds();
+    double interval = (Simulator::Now() - lastReport_).GetSeconds();
+    char row[512];
+
+    for (const auto& s : flowMonitor_->GetFlowStats()) {
+        FlowId id = s.first;
+        const FlowMonitor::FlowStats& stats = s.second;
+        Snapshot& previous = previous_[id];
+        if (stats.txPackets == previous.txPackets && stats.rxPackets == previous.rxPackets) {
+            continue;
+        }
+
+        uint32_t rxPackets = stats.rxPackets - previous.rxPackets;
+        // A flow has one jitter sample less than received packets overall.
+        uint32_t jitterSamples = stats.rxPackets > std::max(previous.rxPackets, 1u) ? stats.rxPackets - std::max(previous.rxPackets, 1u) : 0;
+        auto throughput = (stats.rxBytes - previous.rxBytes) * 8.0 / interval;
+        auto delayMean = rxPackets == 0 ? 0.0 : (stats.delaySum - previous.delaySum).GetSeconds() * 1000 / rxPackets;
+        auto jitterMean = jitterSamples == 0 ? 0.0 : (stats.jitterSum - previous.jitterSum).GetSeconds() * 1000 / jitterSamples;
+        auto delayBins = GetBins(stats.delayHistogram);
+        auto jitterBins = GetBins(stats.jitterHistogram);
+        auto delay = GetPercentiles(delayBins, previous.delayBins);
+        auto jitter = GetPercentiles(jitterBins, previous.jitterBins);
+        auto fiveTuple = classifier_->FindFlow(id);
+
+        uint32_t source = fiveTuple.sourceAddress.Get();
+        uint32_t destination = fiveTuple.destinationAddress.Get();
+
+        std::snprintf(row, sizeof(row), "%g,%u,%u.%u.%u.%u,%u.%u.%u.%u,%u,%u,%u,%.6f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                      now, id,
+                      source >> 24, (source >> 16) & 0xff, (source >> 8) & 0xff, source & 0xff,
+                      destination >> 24, (destination >> 16) & 0xff, (destination >> 8) & 0xff, destination & 0xff,
+                      stats.txPackets - previous.txPackets, rxPackets, stats.lostPackets - previous.lostPackets,
+                      throughput / (1024 * 1024), delayMean, delay[0], delay[1], delay[2],
+                      jitterMean, jitter[0], jitter[1], jitter[2]);
+        file_ << row;
+
+        previous.txPackets = stats.txPackets;
+        previous.rxPackets = stats.rxPackets;
+        previous.lostPackets = stats.lostPackets;
+        previous.rxBytes = stats.rxBytes;
+        previous.delaySum = stats.delaySum;
+        previous.jitterSum = stats.jitterSum;
+        previous.delayBins = std::move(delayBins);
+        previous.jitterBins = std::move(jitterBins);
+    }
+    lastReport_ = Simulator::Now();
+}
+
+#endif // MONITOR_HPP_INCLUDE
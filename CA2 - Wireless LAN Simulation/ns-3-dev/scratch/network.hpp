@@ -1,8 +1,10 @@
 #ifndef NETWORK_HPP_INCLUDE
 #define NETWORK_HPP_INCLUDE
 
-#include <array>
+#include <algorithm>
+#include <cmath>
 #include <ctime>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -11,6 +13,8 @@
 #include "constants.hpp"
 #include "mapper.hpp"
 #include "master.hpp"
+#include "monitor.hpp"
+#include "reducer.hpp"
 #include "ns3/core-module.h"
 #include "ns3/error-model.h"
 #include "ns3/flow-monitor-helper.h"
@@ -22,44 +26,67 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("WifiTopology");
 
+struct Topology {
+    uint32_t clients = consts::CLIENTS_COUNT;
+    uint32_t mappers = consts::MAPPERS_COUNT;
+    uint32_t reducers = consts::REDUCERS_COUNT;
+    uint32_t accessPoints = consts::ACCESS_POINTS_COUNT;
+};
+
+struct Pipeline {
+    bool broadcast = consts::BROADCAST_REQUESTS;
+    uint32_t batchSize = consts::BATCH_SIZE;
+    uint32_t window = consts::WINDOW_SIZE;
+};
+
 class Network {
 public:
-    Network(bool verbose, const std::vector<uint16_t>& clientSendData, const std::vector<std::unordered_map<uint16_t, char>>& mappings);
+    Network(bool verbose, const Topology& topology, const Pipeline& pipeline, const std::vector<uint16_t>& clientSendData, const std::vector<std::unordered_map<uint16_t, char>>& mappings);
     ~Network() = default;
 
-    void Simulate();
+    void Simulate(const std::string& monitorFile);
 
 private:
+    Topology topology_;
+    Pipeline pipeline_;
     std::vector<uint16_t> clientSendData_;
     std::vector<std::unordered_map<uint16_t, char>> mappings_;
-    NodeContainer wifiStaNodeClient_, wifiStaNodeMaster_, wifiStaNodeMapper_;
+    NodeContainer wifiStaNodeClient_, wifiStaNodeMaster_, wifiStaNodeMapper_, wifiStaNodeReducer_;
     YansWifiChannelHelper channel_;
     YansWifiPhyHelper phy_;
     WifiHelper wifi_;
     WifiMacHelper mac_;
-    Ssid ssid_;
-    NetDeviceContainer staDeviceClient_, staDeviceMaster_, staDeviceMapper_;
+    NetDeviceContainer staDeviceClient_, staDeviceMaster_, staDeviceMapper_, staDeviceReducer_;
     MobilityHelper mobility_;
     InternetStackHelper stack_;
     Ipv4AddressHelper address_;
-    Ipv4InterfaceContainer staNodeClientInterface_, staNodeMasterInterface_, staNodeMapperInterface_;
-    Ptr<Client> clientApp_;
+    Ipv4InterfaceContainer staNodeClientInterface_, staNodeMasterInterface_, staNodeMapperInterface_, staNodeReducerInterface_;
+    std::vector<Ptr<Client>> clientApps_;
     Ptr<Master> masterApp_;
-    std::array<Ptr<Mapper>, consts::MAPPERS_COUNT> mapperApps_;
+    std::vector<Ptr<Mapper>> mapperApps_;
+    std::vector<Ptr<Reducer>> reducerApps_;
 
     void Setup();
     void SetupWifi();
     void SetupNodes();
+    uint32_t GetBss(uint32_t idx, uint32_t count) const;
+    NodeContainer GetBssNodes(const NodeContainer& nodes, uint32_t bss) const;
+    NetDeviceContainer GetBssDevices(const NetDeviceContainer& devices, uint32_t bss) const;
 
     static void DelayAndThroughputMonitor(FlowMonitorHelper* fmhelper, Ptr<FlowMonitor> flowMon);
 };
 
-Network::Network(bool verbose, const std::vector<uint16_t>& clientSendData, const std::vector<std::unordered_map<uint16_t, char>>& mappings)
-    : clientSendData_(clientSendData),
+Network::Network(bool verbose, const Topology& topology, const Pipeline& pipeline, const std::vector<uint16_t>& clientSendData, const std::vector<std::unordered_map<uint16_t, char>>& mappings)
+    : topology_(topology),
+      pipeline_(pipeline),
+      clientSendData_(clientSendData),
       mappings_(mappings),
-      channel_(YansWifiChannelHelper::Default()),
-      ssid_(Ssid(consts::SSID)) {
+      channel_(YansWifiChannelHelper::Default()) {
     std::srand(time(nullptr));
+    // The applications start while the stations are still associating. With
+    // many stations some ARP requests are lost then, and the default of 100 s
+    // would keep those neighbors unreachable for the whole simulation.
+    Config::SetDefault("ns3::ArpCache::DeadTimeout", TimeValue(Seconds(consts::ARP_DEAD_TIMEOUT)));
     if (verbose) {
         LogComponentEnable("UdpEchoClientApplication", LOG_LEVEL_INFO);
         LogComponentEnable("UdpEchoServerApplication", LOG_LEVEL_INFO);
@@ -72,73 +99,162 @@ void Network::Setup() {
     SetupNodes();
 }
 
+// The master is the access point of every BSS, with one device per BSS. The
+// stations of each kind are split between the BSSs in consecutive blocks, so
+// that they keep their order in the containers.
+uint32_t Network::GetBss(uint32_t idx, uint32_t count) const {
+    return static_cast<uint64_t>(idx) * topology_.accessPoints / count;
+}
+
+NodeContainer Network::GetBssNodes(const NodeContainer& nodes, uint32_t bss) const {
+    NodeContainer result;
+    for (uint32_t i = 0; i < nodes.GetN(); ++i) {
+        if (GetBss(i, nodes.GetN()) == bss)
+            result.Add(nodes.Get(i));
+    }
+    return result;
+}
+
+NetDeviceContainer Network::GetBssDevices(const NetDeviceContainer& devices, uint32_t bss) const {
+    NetDeviceContainer result;
+    for (uint32_t i = 0; i < devices.GetN(); ++i) {
+        if (GetBss(i, devices.GetN()) == bss)
+            result.Add(devices.Get(i));
+    }
+    return result;
+}
+
 void Network::SetupWifi() {
-    wifiStaNodeClient_.Create(1);
+    wifiStaNodeClient_.Create(topology_.clients);
     wifiStaNodeMaster_.Create(1);
-    wifiStaNodeMapper_.Create(consts::MAPPERS_COUNT);
+    wifiStaNodeMapper_.Create(topology_.mappers);
+    wifiStaNodeReducer_.Create(topology_.reducers);
 
-    phy_.SetChannel(channel_.Create());
     wifi_.SetRemoteStationManager("ns3::AarfWifiManager");
 
-    mac_.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid_), "ActiveProbing", BooleanValue(false));
-    staDeviceClient_ = wifi_.Install(phy_, mac_, wifiStaNodeClient_);
-    mac_.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid_), "ActiveProbing", BooleanValue(false));
-    staDeviceMapper_ = wifi_.Install(phy_, mac_, wifiStaNodeMapper_);
-    mac_.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid_));
-    staDeviceMaster_ = wifi_.Install(phy_, mac_, wifiStaNodeMaster_);
+    phy_.SetChannel(channel_.Create());
+    for (uint32_t bss = 0; bss < topology_.accessPoints; ++bss) {
+        Ssid ssid(bss == 0 ? consts::SSID : consts::SSID + "-" + std::to_string(bss));
+        phy_.Set("ChannelNumber", UintegerValue(consts::CHANNELS[bss % consts::CHANNELS.size()]));
+
+        mac_.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid), "ActiveProbing", BooleanValue(false));
+        staDeviceClient_.Add(wifi_.Install(phy_, mac_, GetBssNodes(wifiStaNodeClient_, bss)));
+        mac_.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid), "ActiveProbing", BooleanValue(false));
+        staDeviceMapper_.Add(wifi_.Install(phy_, mac_, GetBssNodes(wifiStaNodeMapper_, bss)));
+        staDeviceReducer_.Add(wifi_.Install(phy_, mac_, GetBssNodes(wifiStaNodeReducer_, bss)));
+        mac_.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
+        staDeviceMaster_.Add(wifi_.Install(phy_, mac_, wifiStaNodeMaster_));
+    }
+
+    // The stations fill a grid about as wide as it is high, shrunk to
+    // MAX_GRID_SIZE when they are many, and the master sits in its center so
+    // that all of them stay in its range.
+    uint32_t stations = wifiStaNodeClient_.GetN() + wifiStaNodeMapper_.GetN() + wifiStaNodeReducer_.GetN();
+    uint32_t gridWidth = std::max<uint32_t>(consts::GRID_WIDTH, std::ceil(std::sqrt(stations * consts::DELTA_Y / consts::DELTA_X)));
+    uint32_t columns = std::min(gridWidth, stations);
+    uint32_t rows = (stations + gridWidth - 1) / gridWidth;
+    double scale = std::min({1.0,
+                             consts::MAX_GRID_SIZE / std::max(1.0, (columns - 1) * consts::DELTA_X),
+                             consts::MAX_GRID_SIZE / std::max(1.0, (rows - 1) * consts::DELTA_Y)});
+    double deltaX = consts::DELTA_X * scale;
+    double deltaY = consts::DELTA_Y * scale;
 
     phy_.SetErrorRateModel("ns3::YansErrorRateModel");
     mobility_.SetPositionAllocator("ns3::GridPositionAllocator",
                                    "MinX", DoubleValue(0.0),
                                    "MinY", DoubleValue(0.0),
-                                   "DeltaX", DoubleValue(consts::DELTA_X),
-                                   "DeltaY", DoubleValue(consts::DELTA_Y),
-                                   "GridWidth", UintegerValue(consts::GRID_WIDTH),
+                                   "DeltaX", DoubleValue(deltaX),
+                                   "DeltaY", DoubleValue(deltaY),
+                                   "GridWidth", UintegerValue(gridWidth),
                                    "LayoutType", StringValue("RowFirst"));
 
     mobility_.SetMobilityModel("ns3::RandomWalk2dMobilityModel", "Bounds",
-                               RectangleValue(Rectangle(-50, 50, -50, 50)));
+                               RectangleValue(Rectangle(-consts::WALK_BOUND, consts::WALK_BOUND,
+                                                        -consts::WALK_BOUND, consts::WALK_BOUND)));
     mobility_.Install(wifiStaNodeClient_);
     mobility_.SetMobilityModel("ns3::ConstantPositionMobilityModel");
     mobility_.Install(wifiStaNodeMapper_);
+    mobility_.Install(wifiStaNodeReducer_);
+
+    Ptr<ListPositionAllocator> center = CreateObject<ListPositionAllocator>();
+    center->Add(Vector((columns - 1) * deltaX / 2, (rows - 1) * deltaY / 2, 0.0));
+    mobility_.SetPositionAllocator(center);
     mobility_.SetMobilityModel("ns3::ConstantPositionMobilityModel");
     mobility_.Install(wifiStaNodeMaster_);
 
     stack_.Install(wifiStaNodeClient_);
     stack_.Install(wifiStaNodeMaster_);
     stack_.Install(wifiStaNodeMapper_);
+    stack_.Install(wifiStaNodeReducer_);
 }
 
 void Network::SetupNodes() {
-    address_.SetBase(consts::BASE_ADDRESS, consts::NET_MASK);
-    staNodeClientInterface_ = address_.Assign(staDeviceClient_);
-    staNodeMasterInterface_ = address_.Assign(staDeviceMaster_);
-    staNodeMapperInterface_ = address_.Assign(staDeviceMapper_);
-
-    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    Ipv4Address base(consts::BASE_ADDRESS);
+    for (uint32_t bss = 0; bss < topology_.accessPoints; ++bss) {
+        address_.SetBase(Ipv4Address(base.Get() + (bss << 16)), consts::NET_MASK);
+        staNodeClientInterface_.Add(address_.Assign(GetBssDevices(staDeviceClient_, bss)));
+        staNodeMasterInterface_.Add(address_.Assign(staDeviceMaster_.Get(bss)));
+        staNodeMapperInterface_.Add(address_.Assign(GetBssDevices(staDeviceMapper_, bss)));
+        staNodeReducerInterface_.Add(address_.Assign(GetBssDevices(staDeviceReducer_, bss)));
+    }
 
-    clientApp_ = CreateObject<Client>(consts::CLIENT_PORT, staNodeClientInterface_, consts::MASTER_PORT, staNodeMasterInterface_, clientSendData_);
-    wifiStaNodeClient_.Get(0)->AddApplication(clientApp_);
+    // All BSSs share one channel object so that those on the same channel
+    // number contend, and global routing cannot tell their subnets apart on
+    // it. The master is in every subnet, so each station only needs a default
+    // route through the master's address in its own BSS.
+    Ipv4StaticRoutingHelper routing;
+    auto addDefaultRoutes = [&](const NodeContainer& nodes) {
+        for (uint32_t i = 0; i < nodes.GetN(); ++i) {
+            Ipv4Address masterIp = staNodeMasterInterface_.GetAddress(GetBss(i, nodes.GetN()));
+            routing.GetStaticRouting(nodes.Get(i)->GetObject<Ipv4>())->SetDefaultRoute(masterIp, 1);
+        }
+    };
+    addDefaultRoutes(wifiStaNodeClient_);
+    addDefaultRoutes(wifiStaNodeMapper_);
+    addDefaultRoutes(wifiStaNodeReducer_);
+
+    for (uint32_t i = 0; i < topology_.clients; ++i) {
+        Ipv4Address masterIp = staNodeMasterInterface_.GetAddress(GetBss(i, topology_.clients));
+        clientApps_.push_back(CreateObject<Client>(consts::CLIENT_PORT, staNodeClientInterface_, i, consts::MASTER_PORT, masterIp, clientSendData_,
+                                                   pipeline_.batchSize, pipeline_.window));
+        wifiStaNodeClient_.Get(i)->AddApplication(clientApps_[i]);
+    }
 
-    masterApp_ = CreateObject<Master>(consts::MASTER_PORT, staNodeMasterInterface_, consts::MAPPER_PORTS, staNodeMapperInterface_);
+    masterApp_ = CreateObject<Master>(consts::MASTER_PORT, staNodeMasterInterface_, consts::MAPPER_PORT, staNodeMapperInterface_,
+                                      consts::VALID_CHARACTERS.size(), pipeline_.broadcast);
     wifiStaNodeMaster_.Get(0)->AddApplication(masterApp_);
 
-    for (unsigned i = 0; i < consts::MAPPERS_COUNT; ++i) {
-        mapperApps_[i] = CreateObject<Mapper>(consts::MAPPER_PORTS[i], staNodeMapperInterface_, i, mappings_[i]);
+    for (uint32_t i = 0; i < topology_.mappers; ++i) {
+        mapperApps_.push_back(CreateObject<Mapper>(consts::MAPPER_PORT, staNodeMapperInterface_, i, mappings_[i],
+                                                   consts::REDUCER_PORT, staNodeReducerInterface_));
         wifiStaNodeMapper_.Get(i)->AddApplication(mapperApps_[i]);
     }
+
+    for (uint32_t i = 0; i < topology_.reducers; ++i) {
+        reducerApps_.push_back(CreateObject<Reducer>(consts::REDUCER_PORT, staNodeReducerInterface_, i));
+        wifiStaNodeReducer_.Get(i)->AddApplication(reducerApps_[i]);
+    }
 }
 
-void Network::Simulate() {
-    clientApp_->SetStartTime(Seconds(0.0));
-    clientApp_->SetStopTime(Seconds(consts::DURATION));
+void Network::Simulate(const std::string& monitorFile) {
+    // The stations associate in the first beacon interval. The master connects
+    // to the mappers after that, and the clients start once it is connected.
+    for (auto& clientApp : clientApps_) {
+        clientApp->SetStartTime(Seconds(consts::CLIENT_START_TIME));
+        clientApp->SetStopTime(Seconds(consts::DURATION));
+    }
 
-    masterApp_->SetStartTime(Seconds(0.0));
+    masterApp_->SetStartTime(Seconds(consts::MASTER_START_TIME));
     masterApp_->SetStopTime(Seconds(consts::DURATION));
 
-    for (unsigned i = 0; i < consts::MAPPERS_COUNT; ++i) {
-        mapperApps_[i]->SetStartTime(Seconds(0.0));
-        mapperApps_[i]->SetStopTime(Seconds(consts::DURATION));
+    for (auto& mapperApp : mapperApps_) {
+        mapperApp->SetStartTime(Seconds(0.0));
+        mapperApp->SetStopTime(Seconds(consts::DURATION));
+    }
+
+    for (auto& reducerApp : reducerApps_) {
+        reducerApp->SetStartTime(Seconds(0.0));
+        reducerApp->SetStopTime(Seconds(consts::DURATION));
     }
 
     NS_LOG_INFO("Run Simulation");
@@ -146,10 +262,18 @@ void Network::Simulate() {
     Ptr<FlowMonitor> flowMonitor;
     FlowMonitorHelper flowHelper;
     flowMonitor = flowHelper.InstallAll();
-    DelayAndThroughputMonitor(&flowHelper, flowMonitor);
+    std::unique_ptr<IntervalMonitor> intervalMonitor;
+    if (!monitorFile.empty()) {
+        intervalMonitor.reset(new IntervalMonitor(flowMonitor, DynamicCast<Ipv4FlowClassifier>(flowHelper.GetClassifier()), monitorFile));
+        intervalMonitor->Start();
+    }
 
     Simulator::Stop(Seconds(consts::SIMULATION_DURATION));
     Simulator::Run();
+    if (intervalMonitor) {
+        intervalMonitor->Finish();
+    }
+    DelayAndThroughputMonitor(&flowHelper, flowMonitor);
 }
 
 void Network::DelayAndThroughputMonitor(FlowMonitorHelper* fmhelper, Ptr<FlowMonitor> flowMon) {
@@ -164,20 +288,18 @@ void Network::DelayAndThroughputMonitor(FlowMonitorHelper* fmhelper, Ptr<FlowMon
         auto throughput = stats.rxBytes * 8.0 / duration;
         auto fiveTuple = classing->FindFlow(id);
 
-        std::cout << "---------------------------------------------------------------------------" << std::endl;
+        std::cout << "---------------------------------------------------------------------------\n";
         std::cout << "Flow ID              : " << id << " ; "
-                  << fiveTuple.sourceAddress << " -----> " << fiveTuple.destinationAddress << std::endl;
-        std::cout << "Tx Packets           : " << stats.txPackets << std::endl;
-        std::cout << "Rx Packets           : " << stats.rxPackets << std::endl;
-        std::cout << "Duration             : " << duration << std::endl;
-        std::cout << "Last Received Packet : " << stats.timeLastRxPacket.GetSeconds() << " Seconds" << std::endl;
-        std::cout << "Throughput           : " << throughput / (1024 * 1024) << " Mbps" << std::endl;
-        std::cout << "Sum of e2e Delay     : " << stats.delaySum.GetSeconds() << "s" << std::endl;
-        std::cout << "Average of e2e Delay : " << stats.delaySum.GetSeconds() / stats.rxPackets << "s" << std::endl;
-        std::cout << "---------------------------------------------------------------------------" << std::endl;
+                  << fiveTuple.sourceAddress << " -----> " << fiveTuple.destinationAddress << '\n';
+        std::cout << "Tx Packets           : " << stats.txPackets << '\n';
+        std::cout << "Rx Packets           : " << stats.rxPackets << '\n';
+        std::cout << "Duration             : " << duration << '\n';
+        std::cout << "Last Received Packet : " << stats.timeLastRxPacket.GetSeconds() << " Seconds\n";
+        std::cout << "Throughput           : " << throughput / (1024 * 1024) << " Mbps\n";
+        std::cout << "Sum of e2e Delay     : " << stats.delaySum.GetSeconds() << "s\n";
+        std::cout << "Average of e2e Delay : " << stats.delaySum.GetSeconds() / stats.rxPackets << "s\n";
+        std::cout << "---------------------------------------------------------------------------\n";
     }
-
-    Simulator::Schedule(Seconds(consts::MONITOR_TIME_INTERVAL), &DelayAndThroughputMonitor, fmhelper, flowMon);
 }
 
 #endif // NETWORK_HPP_INCLUDE
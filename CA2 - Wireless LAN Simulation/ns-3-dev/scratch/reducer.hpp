@@ -0,0 +1,77 @@
+#ifndef REDUCER_HPP_INCLUDE
+#define REDUCER_HPP_INCLUDE
+
+#include <map>
+
+#include "header.hpp"
+#include "ns3/applications-module.h"
+#include "ns3/internet-module.h"
+
+using namespace ns3;
+
+class Reducer : public Application {
+public:
+    Reducer(uint16_t port, Ipv4InterfaceContainer& ip, unsigned idx);
+    virtual ~Reducer();
+
+private:
+    void StartApplication(void) override;
+    void HandleRead(Ptr<Socket> socket);
+
+    uint16_t port_;
+    Ipv4InterfaceContainer ip_;
+    unsigned idx_;
+    Ptr<Socket> socket_;
+    std::map<char, uint32_t> counts_;
+    uint32_t reduced_ = 0;
+};
+
+Reducer::Reducer(uint16_t port, Ipv4InterfaceContainer& ip, unsigned idx)
+    : port_(port),
+      ip_(ip),
+      idx_(idx) {}
+
+Reducer::~Reducer() {
+    std::cout << "Reducer " << idx_ << " reduced " << reduced_ << " characters:";
+    for (const auto& count : counts_) {
+        std::cout << " '" << count.first << "' " << count.second;
+    }
+    std::cout << std::endl;
+}
+
+void Reducer::StartApplication(void) {
+    socket_ = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+    InetSocketAddress local(ip_.GetAddress(idx_), port_);
+    socket_->Bind(local);
+    socket_->SetRecvCallback(MakeCallback(&Reducer::HandleRead, this));
+}
+
+// Counts the mapped characters and passes them on to the client they belong to.
+void Reducer::HandleRead(Ptr<Socket> socket) {
+    Ptr<Packet> packet;
+
+    while (packet = socket->Recv()) {
+        if (packet->GetSize() == 0) {
+            break;
+        }
+
+        ClientHeader header;
+        packet->RemoveHeader(header);
+
+        MapperHeader result;
+        result.SetSeq(header.GetSeq());
+        for (uint8_t i = 0; i < header.GetCount(); ++i) {
+            char data = header.GetData(i);
+            ++counts_[data];
+            ++reduced_;
+            result.AddData(header.GetOffset(i), data);
+        }
+        Ptr<Packet> reply = Create<Packet>();
+        reply->AddHeader(result);
+
+        InetSocketAddress destination(header.GetSourceIP(), header.GetSourcePort());
+        socket_->SendTo(reply, 0, destination);
+    }
+}
+
+#endif // REDUCER_HPP_INCLUDE
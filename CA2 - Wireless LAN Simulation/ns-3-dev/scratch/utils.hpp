@@ -9,6 +9,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "ns3/ipv4-address.h"
+
 namespace utils {
 
 inline std::string shuffle(const std::string& chars) {
@@ -27,9 +29,13 @@ inline std::vector<uint16_t> reverseMap(const std::string& chars, const std::str
     return result;
 }
 
+inline unsigned partitionCharCount(size_t charCount, unsigned partitionCount) {
+    return std::ceil(charCount / static_cast<double>(partitionCount));
+}
+
 inline std::vector<std::unordered_map<uint16_t, char>> partitionMappings(const std::string& chars, unsigned partitionCount) {
     std::vector<std::unordered_map<uint16_t, char>> result(partitionCount);
-    unsigned partitionCharCount = std::ceil(chars.size() / static_cast<double>(partitionCount));
+    unsigned partitionCharCount = utils::partitionCharCount(chars.size(), partitionCount);
 
     for (unsigned i = 0; i < partitionCount; ++i) {
         for (unsigned j = 0; j < partitionCharCount; ++j) {
@@ -43,6 +49,17 @@ inline std::vector<std::unordered_map<uint16_t, char>> partitionMappings(const s
     return result;
 }
 
+// Partition of partitionMappings that has the mapping of the given index.
+inline unsigned partitionOf(uint16_t index, size_t charCount, unsigned partitionCount) {
+    return index / partitionCharCount(charCount, partitionCount);
+}
+
+// Reducer that collects the results of a client. The clients have consecutive
+// addresses, so they are spread evenly.
+inline unsigned reducerOf(ns3::Ipv4Address ip, unsigned reducerCount) {
+    return ip.Get() % reducerCount;
+}
+
 } // namespace utils
 
 #endif // UTILS_HPP_INCLUDE
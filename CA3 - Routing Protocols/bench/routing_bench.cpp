@@ -0,0 +1,172 @@
+#include <sys/resource.h>
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "network.hpp"
+#include "topology_generator.hpp"
+#include "utils.hpp"
+
+struct Engine {
+    std::string name;
+    std::function<void(Network&, Node*)> run;
+    bool runByDefault = true;
+};
+
+const std::vector<Engine> ENGINES = {
+    {"lsrp", [](Network& network, Node* src) { network.getLsrpTable(src); }},
+    {"dvrp-bf", [](Network& network, Node* src) { network.getDvrpTable(src, Network::DvrpEngine::bellmanFord); }},
+    {"dvrp-spfa", [](Network& network, Node* src) { network.getDvrpTable(src, Network::DvrpEngine::spfa); }},
+    {"dvrp-simd", [](Network& network, Node* src) { network.getDvrpTable(src, Network::DvrpEngine::vectorized); }},
+    {"delta", [](Network& network, Node* src) { network.getDeltaSteppingTable(src); }},
+    {"ecmp", [](Network& network, Node* src) { network.getEcmpTable(src); }},
+    // All-pairs engines and the flooding simulation grow at least with the square of the node count, so they only run when asked for.
+    {"apsp", [](Network& network, Node*) { network.getAllPairsTable(); }, false},
+    {"flood", [](Network& network, Node* src) { network.simulateLinkState(src); }, false},
+};
+
+struct BenchOptions {
+    std::vector<std::string> graphs = {"er", "ba", "grid", "fattree"};
+    std::vector<int> sizes = {1000, 4000};
+    std::vector<std::string> engines;
+    int sources = 3;
+    generator::Options generator;
+};
+
+// Resets the peak resident set size (VmHWM) of the process, Linux only.
+void resetPeakRss() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+}
+
+long peakRssKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+bool parseArgs(int argc, char* argv[], BenchOptions& options) {
+    for (auto& engine : ENGINES) {
+        if (engine.runByDefault) {
+            options.engines.push_back(engine.name);
+        }
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            return false;
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+        if (key != "graphs" && key != "engines" && key != "sizes" && !utils::isNumber(value)) {
+            return false;
+        }
+
+        if (key == "graphs") {
+            options.graphs = utils::split(value, ',');
+        }
+        else if (key == "engines") {
+            options.engines = utils::split(value, ',');
+        }
+        else if (key == "sizes") {
+            options.sizes.clear();
+            for (auto& size : utils::split(value, ',')) {
+                if (!utils::isNumber(size)) return false;
+                options.sizes.push_back(std::stoi(size));
+            }
+        }
+        else if (key == "sources") options.sources = std::stoi(value);
+        else if (key == "degree") options.generator.averageDegree = std::stoi(value);
+        else if (key == "max-weight") options.generator.maxWeight = std::stoi(value);
+        else if (key == "seed") options.generator.seed = std::stoul(value);
+        else return false;
+    }
+    return true;
+}
+
+const Engine* findEngine(const std::string& name) {
+    for (auto& engine : ENGINES) {
+        if (engine.name == name) {
+            return &engine;
+        }
+    }
+    return nullptr;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "Usage: bench.out [--graphs=er,ba,grid,fattree] [--sizes=1000,4000] [--engines=lsrp,dvrp-bf,dvrp-spfa,dvrp-simd,delta,ecmp,apsp,flood]"
+                     " [--sources=3] [--degree=4] [--max-weight=100] [--seed=1]\n";
+        return 1;
+    }
+
+    std::vector<const Engine*> engines;
+    for (auto& name : options.engines) {
+        const Engine* engine = findEngine(name);
+        if (engine == nullptr) {
+            std::cerr << "Unknown engine: " << name << '\n';
+            return 1;
+        }
+        engines.push_back(engine);
+    }
+
+    std::cout << "graph,nodes,edges,engine,source,runtime_ms,peak_rss_kb,relaxations,heap_operations\n";
+    for (auto& graph : options.graphs) {
+        generator::Kind kind;
+        if (!generator::parseKind(graph, kind)) {
+            std::cerr << "Unknown graph: " << graph << '\n';
+            return 1;
+        }
+        for (int size : options.sizes) {
+            generator::Options genOptions = options.generator;
+            genOptions.nodes = size;
+            auto topology = generator::generate(kind, genOptions);
+            int edgeCount = topology.csr.edgeCount() / 2;
+
+            Network network;
+            network.loadGraph(std::move(topology.names), std::move(topology.csr));
+            int nodeCount = network.getNodes().size();
+            if (nodeCount == 0) {
+                continue;
+            }
+
+            std::mt19937 gen(options.generator.seed);
+            std::uniform_int_distribution<int> pick(0, nodeCount - 1);
+            std::vector<int> sources(options.sources);
+            for (auto& source : sources) {
+                source = pick(gen);
+            }
+
+            for (auto engine : engines) {
+                for (int source : sources) {
+                    network.resetStats();
+                    resetPeakRss();
+                    auto start = std::chrono::high_resolution_clock::now();
+                    engine->run(network, network[source]);
+                    auto end = std::chrono::high_resolution_clock::now();
+                    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+                    const RoutingStats& stats = network.getStats();
+
+                    std::cout << graph << ',' << nodeCount << ',' << edgeCount << ',' << engine->name << ','
+                              << source << ',' << duration << ',' << peakRssKb() << ','
+                              << stats.relaxations << ',' << stats.heapOperations << '\n';
+                }
+            }
+        }
+    }
+    return 0;
+}
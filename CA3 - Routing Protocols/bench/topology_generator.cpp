@@ -0,0 +1,166 @@
+#include "topology_generator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <unordered_map>
+
+namespace generator {
+
+namespace {
+
+std::vector<CsrEdge> erdosRenyi(const Options& options, std::mt19937& gen) {
+    if (options.nodes < 2) {
+        return {};
+    }
+    std::uniform_int_distribution<int> node(0, options.nodes - 1);
+    long long target = static_cast<long long>(options.nodes) * options.averageDegree / 2;
+    std::vector<CsrEdge> edges;
+    edges.reserve(target);
+    while (static_cast<long long>(edges.size()) < target) {
+        int u = node(gen);
+        int v = node(gen);
+        if (u != v) {
+            edges.push_back({u, v, 0});
+        }
+    }
+    return edges;
+}
+
+// Every new node links to m existing nodes picked proportionally to their degree.
+std::vector<CsrEdge> barabasiAlbert(const Options& options, std::mt19937& gen) {
+    int m = std::max(1, options.averageDegree / 2);
+    std::vector<CsrEdge> edges;
+    std::vector<int> endpoints;
+    for (int u = 1; u <= m && u < options.nodes; ++u) {
+        for (int v = 0; v < u; ++v) {
+            edges.push_back({u, v, 0});
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+    std::vector<int> targets;
+    for (int u = m + 1; u < options.nodes; ++u) {
+        std::uniform_int_distribution<size_t> pick(0, endpoints.size() - 1);
+        targets.clear();
+        while (static_cast<int>(targets.size()) < m) {
+            int v = endpoints[pick(gen)];
+            if (std::find(targets.begin(), targets.end(), v) == targets.end()) {
+                targets.push_back(v);
+            }
+        }
+        for (int v : targets) {
+            edges.push_back({u, v, 0});
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+    return edges;
+}
+
+std::vector<CsrEdge> grid(int side) {
+    std::vector<CsrEdge> edges;
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            int u = r * side + c;
+            if (c + 1 < side) edges.push_back({u, u + 1, 0});
+            if (r + 1 < side) edges.push_back({u, u + side, 0});
+        }
+    }
+    return edges;
+}
+
+int fatTreeArity(int nodes) {
+    int k = 2;
+    auto size = [](int k) { return 5 * k * k / 4 + k * k * k / 4; };
+    while (size(k + 2) <= nodes) {
+        k += 2;
+    }
+    return k;
+}
+
+// Nodes are laid out as core switches, then per pod aggregation, edge and host nodes.
+std::vector<CsrEdge> fatTree(int k) {
+    int half = k / 2;
+    int core = half * half;
+    int podSize = k + half * half;
+    std::vector<CsrEdge> edges;
+    for (int pod = 0; pod < k; ++pod) {
+        int base = core + pod * podSize;
+        for (int a = 0; a < half; ++a) {
+            int aggregation = base + a;
+            for (int c = 0; c < half; ++c) {
+                edges.push_back({aggregation, a * half + c, 0});
+            }
+            for (int e = 0; e < half; ++e) {
+                edges.push_back({aggregation, base + half + e, 0});
+            }
+        }
+        for (int e = 0; e < half; ++e) {
+            int edgeSwitch = base + half + e;
+            for (int h = 0; h < half; ++h) {
+                edges.push_back({edgeSwitch, base + k + e * half + h, 0});
+            }
+        }
+    }
+    return edges;
+}
+
+} // namespace
+
+bool parseKind(const std::string& name, Kind& kind) {
+    static const std::unordered_map<std::string, Kind> kinds = {
+        {"er", Kind::erdosRenyi},
+        {"ba", Kind::barabasiAlbert},
+        {"grid", Kind::grid},
+        {"fattree", Kind::fatTree},
+    };
+    auto it = kinds.find(name);
+    if (it == kinds.end()) {
+        return false;
+    }
+    kind = it->second;
+    return true;
+}
+
+GeneratedTopology generate(Kind kind, const Options& options) {
+    std::mt19937 gen(options.seed);
+    int nodeCount = options.nodes;
+    std::vector<CsrEdge> edges;
+    switch (kind) {
+    case Kind::erdosRenyi:
+        edges = erdosRenyi(options, gen);
+        break;
+    case Kind::barabasiAlbert:
+        edges = barabasiAlbert(options, gen);
+        break;
+    case Kind::grid: {
+        int side = std::max(1, static_cast<int>(std::sqrt(options.nodes)));
+        nodeCount = side * side;
+        edges = grid(side);
+        break;
+    }
+    case Kind::fatTree: {
+        int k = fatTreeArity(options.nodes);
+        nodeCount = 5 * k * k / 4 + k * k * k / 4;
+        edges = fatTree(k);
+        break;
+    }
+    }
+
+    std::uniform_int_distribution<int> weight(1, std::max(1, options.maxWeight));
+    for (auto& edge : edges) {
+        edge.weight = weight(gen);
+    }
+
+    GeneratedTopology topology;
+    topology.names.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        topology.names.push_back(std::to_string(i));
+    }
+    int duplicates = 0;
+    topology.csr = buildCsrGraph(nodeCount, edges, duplicates);
+    return topology;
+}
+
+} // namespace generator
@@ -0,0 +1,39 @@
+#ifndef TOPOLOGY_GENERATOR_HPP_INCLUDE
+#define TOPOLOGY_GENERATOR_HPP_INCLUDE
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "csr_graph.hpp"
+
+namespace generator {
+
+enum class Kind {
+    erdosRenyi,
+    barabasiAlbert,
+    grid,
+    fatTree,
+};
+
+struct GeneratedTopology {
+    std::vector<std::string> names;
+    CsrGraph csr;
+};
+
+struct Options {
+    int nodes = 1000;
+    int averageDegree = 4;
+    int maxWeight = 100;
+    uint32_t seed = 1;
+};
+
+bool parseKind(const std::string& name, Kind& kind);
+
+// Sizes are approximate for grid (rounded to a square) and fat-tree
+// (largest even k whose switches and hosts fit in the given node count).
+GeneratedTopology generate(Kind kind, const Options& options);
+
+} // namespace generator
+
+#endif // TOPOLOGY_GENERATOR_HPP_INCLUDE
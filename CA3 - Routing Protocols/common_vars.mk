@@ -1,5 +1,8 @@
 CXX       = g++
 CXXFLAGS += -Wall -pedantic
+CXXFLAGS += -O2 -pthread
+ARCHFLAGS ?= -march=native
+CXXFLAGS += $(ARCHFLAGS)
 CXX      += $(CXXFLAGS)
 CPPFLAGS += -std=c++17
 
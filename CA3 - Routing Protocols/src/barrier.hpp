@@ -0,0 +1,32 @@
+#ifndef BARRIER_HPP_INCLUDE
+#define BARRIER_HPP_INCLUDE
+
+#include <condition_variable>
+#include <mutex>
+
+// Reusable thread barrier (std::barrier is C++20).
+class Barrier {
+public:
+    Barrier(int count) : count_(count) {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        long generation = generation_;
+        if (++waiting_ == count_) {
+            waiting_ = 0;
+            ++generation_;
+            cv_.notify_all();
+            return;
+        }
+        cv_.wait(lock, [&] { return generation != generation_; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    int count_;
+    int waiting_ = 0;
+    long generation_ = 0;
+};
+
+#endif // BARRIER_HPP_INCLUDE
@@ -3,26 +3,38 @@
 #include <chrono>
 #include <iostream>
 
+#include "topology_io.hpp"
 #include "utils.hpp"
 
-CommandLineInterface::CommandLineInterface(Network& network) : network_(network) {
+CommandLineInterface::CommandLineInterface(Network& network, OutputWriter& out) : network_(network), out_(out) {
     commands_ = {
         {"help", std::bind(&CommandLineInterface::help, this, std::placeholders::_1)},
         {"topology", std::bind(&CommandLineInterface::topology, this, std::placeholders::_1)},
         {"show", std::bind(&CommandLineInterface::show, this, std::placeholders::_1)},
         {"modify", std::bind(&CommandLineInterface::modify, this, std::placeholders::_1)},
         {"remove", std::bind(&CommandLineInterface::remove, this, std::placeholders::_1)},
+        {"load", std::bind(&CommandLineInterface::load, this, std::placeholders::_1)},
+        {"save", std::bind(&CommandLineInterface::save, this, std::placeholders::_1)},
         {"lsrp", std::bind(&CommandLineInterface::lsrp, this, std::placeholders::_1)},
         {"dvrp", std::bind(&CommandLineInterface::dvrp, this, std::placeholders::_1)},
+        {"delta", std::bind(&CommandLineInterface::delta, this, std::placeholders::_1)},
+        {"apsp", std::bind(&CommandLineInterface::apsp, this, std::placeholders::_1)},
+        {"ecmp", std::bind(&CommandLineInterface::ecmp, this, std::placeholders::_1)},
+        {"ksp", std::bind(&CommandLineInterface::ksp, this, std::placeholders::_1)},
+        {"route", std::bind(&CommandLineInterface::route, this, std::placeholders::_1)},
+        {"flood", std::bind(&CommandLineInterface::flood, this, std::placeholders::_1)},
     };
 }
 
-void CommandLineInterface::run() {
+void CommandLineInterface::run(std::istream& input, bool interactive) {
     std::string line;
     std::vector<std::string> args;
     while (true) {
-        std::cout << "> ";
-        if (!std::getline(std::cin, line)) {
+        if (interactive) {
+            out_.flush();
+            std::cout << "> " << std::flush;
+        }
+        if (!std::getline(input, line)) {
             break;
         }
         if (line.empty()) {
@@ -30,6 +42,9 @@ void CommandLineInterface::run() {
         }
 
         args = utils::split(line, ' ');
+        if (args.empty()) {
+            continue;
+        }
         std::string command = args[0];
         args.erase(args.begin());
 
@@ -37,17 +52,18 @@ void CommandLineInterface::run() {
             break;
         }
         if (commands_.find(command) == commands_.end()) {
-            std::cout << "Unknown command: " << command << std::endl;
+            out_.error("Unknown command: " + command);
             continue;
         }
 
         try {
-            std::cout << commands_.at(command)(args) << std::endl;
+            out_.text(commands_.at(command)(args));
         }
         catch (const std::exception& e) {
-            std::cout << "Error: " << e.what() << std::endl;
+            out_.error("Error: " + std::string(e.what()));
         }
     }
+    out_.flush();
 }
 
 std::string CommandLineInterface::help(const std::vector<std::string>& args) {
@@ -58,8 +74,21 @@ std::string CommandLineInterface::help(const std::vector<std::string>& args) {
         "\n  show                   - show the current topology"
         "\n  modify <s>-<d>-<w>     - modify the weight of an edge"
         "\n  remove <s>-<d>         - remove an edge"
+        "\n  load <file> [<format>] - replace the topology with a file (edges, csv, rocketfuel or caida, saved files are detected)"
+        "\n  save <file>            - save the topology in the binary format"
         "\n  lsrp <s>               - run the link state routing protocol"
-        "\n  dvrp <s>               - run the distance vector routing protocol"
+        "\n  dvrp <s> [--bf|--spfa|--simd]"
+        "\n                         - run the distance vector routing protocol"
+        "\n  delta <s> [--delta=<d>] [--threads=<n>]"
+        "\n                         - run the parallel delta-stepping shortest path engine"
+        "\n  apsp [--threads=<n>]   - show all-pairs shortest distances (blocked Floyd-Warshall)"
+        "\n  ecmp <s>               - show the equal-cost next hops and load shares"
+        "\n  ksp <s> <d> <k>        - show the k shortest loopless paths"
+        "\n  route <s> <d> [--threads=<n>]"
+        "\n                         - show the shortest path using a contraction hierarchy"
+        "\n  flood [<s>] [--threads=<n>] [--delay=<t>] [--hold=<t>] [--max-hold=<t>] [--max-age=<t>]"
+        "\n        [--fail=<a>-<b>@<t>] [--set=<a>-<b>-<w>@<t>]"
+        "\n                         - simulate link state flooding and per-router SPF"
         "\n  exit                   - exit the program\n";
     return help;
 }
@@ -75,12 +104,10 @@ std::string CommandLineInterface::topology(const std::vector<std::string>& args)
         if (edge.size() != 3) {
             return usage;
         }
-        if (!utils::isNumber(edge[2])) {
-            return "Weight must be a number";
-        }
-        int weight = std::stoi(edge[2]);
-        if (weight <= 0) {
-            return "Weight must be positive";
+        int weight = 0;
+        std::string error = parseWeight(edge[2], weight);
+        if (!error.empty()) {
+            return error;
         }
         if (edge[0] == edge[1]) {
             return "Self-loop is not allowed";
@@ -97,35 +124,39 @@ std::string CommandLineInterface::topology(const std::vector<std::string>& args)
 }
 
 std::string CommandLineInterface::show(const std::vector<std::string>& args) {
-    auto nodes = network_.getNodes();
-    auto adjMatrix = network_.getAdjacencyMatrix();
-
-    int maxLen = 0;
-    for (auto node : nodes) {
-        maxLen = std::max<int>(maxLen, node->getName().size());
-    }
-    for (const auto& adjRow : adjMatrix) {
-        for (auto adjCell : adjRow) {
-            maxLen = std::max<int>(maxLen, std::to_string(adjCell).size());
-        }
+    if (!canRenderMatrix()) {
+        return getMatrixSkippedMessage();
     }
+    writeMatrix(network_.getAdjacencyMatrix());
+    return "";
+}
 
-    std::string result;
-    result += utils::replicate(' ', maxLen) + " | ";
+bool CommandLineInterface::canRenderMatrix() const {
+    return out_.getFormat() != OutputWriter::Format::table || network_.getNodes().size() <= MAX_RENDERED_NODES;
+}
+
+std::string CommandLineInterface::getMatrixSkippedMessage() const {
+    return "The topology has " + std::to_string(network_.getNodes().size()) + " nodes, use --format=csv or --format=binary to print its matrix";
+}
+
+void CommandLineInterface::writeMatrix(const DistanceMatrix& matrix) const {
+    auto nodes = network_.getNodes();
+    std::vector<std::string> names;
+    names.reserve(nodes.size());
     for (auto node : nodes) {
-        result += utils::rjust(node->getName(), maxLen) + ' ';
+        names.push_back(node->getName());
     }
-    int lineLen = result.size();
-    result += '\n';
-    result += utils::replicate('-', lineLen) + '\n';
-    for (unsigned i = 0; i < adjMatrix.size(); ++i) {
-        result += utils::rjust(nodes[i]->getName(), maxLen) + " | ";
-        for (unsigned j = 0; j < adjMatrix[i].size(); ++j) {
-            result += utils::rjust(std::to_string(adjMatrix[i][j]), maxLen) + ' ';
+    out_.beginTable(OutputWriter::Style::matrix, names);
+
+    std::vector<int> values(matrix.size());
+    for (int i = 0; i < matrix.size(); ++i) {
+        const int* row = matrix.row(i);
+        for (int j = 0; j < matrix.size(); ++j) {
+            values[j] = row[j] == INF_DISTANCE ? -1 : row[j];
         }
-        result += '\n';
+        out_.matrixRow(names[i], values);
     }
-    return result;
+    out_.endTable();
 }
 
 std::string CommandLineInterface::modify(const std::vector<std::string>& args) {
@@ -138,12 +169,10 @@ std::string CommandLineInterface::modify(const std::vector<std::string>& args) {
     if (edge.size() != 3) {
         return usage;
     }
-    if (!utils::isNumber(edge[2])) {
-        return "Weight must be a number";
-    }
-    int weight = std::stoi(edge[2]);
-    if (weight <= 0) {
-        return "Weight must be positive";
+    int weight = 0;
+    std::string error = parseWeight(edge[2], weight);
+    if (!error.empty()) {
+        return error;
     }
     if (edge[0] == edge[1]) {
         return "Self-loop is not allowed";
@@ -183,6 +212,48 @@ std::string CommandLineInterface::remove(const std::vector<std::string>& args) {
     return "OK";
 }
 
+std::string CommandLineInterface::load(const std::vector<std::string>& args) {
+    static const std::string usage = "Usage: load <file> [edges|csv|rocketfuel|caida]";
+    if (args.empty() || args.size() > 2) {
+        return usage;
+    }
+
+    topology_io::Format format = topology_io::guessFormat(args[0]);
+    if (args.size() == 2 && !topology_io::parseFormat(args[1], format)) {
+        return usage;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto topology = topology_io::load(args[0], format);
+    int nodeCount = topology.names.size();
+    int edgeCount = topology.csr.edgeCount() / 2;
+    network_.loadGraph(std::move(topology.names), std::move(topology.csr));
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+
+    std::string result = "Loaded " + std::to_string(nodeCount) + " nodes and " + std::to_string(edgeCount) + " edges";
+    if (topology.skippedEdges != 0) {
+        result += " (skipped " + std::to_string(topology.skippedEdges) + " self-loops and duplicates)";
+    }
+    result += "\nTime elapsed: " + std::to_string(duration) + "ms";
+    return result;
+}
+
+std::string CommandLineInterface::save(const std::vector<std::string>& args) {
+    static const std::string usage = "Usage: save <file>";
+    if (args.size() != 1) {
+        return usage;
+    }
+
+    std::vector<std::string> names;
+    names.reserve(network_.getNodes().size());
+    for (auto node : network_.getNodes()) {
+        names.push_back(node->getName());
+    }
+    topology_io::save(args[0], names, network_.getCsrGraph());
+    return "OK";
+}
+
 std::string CommandLineInterface::lsrp(const std::vector<std::string>& args) {
     static const std::string usage = "Usage: lsrp <s>";
     if (args.size() > 1) {
@@ -201,21 +272,36 @@ std::string CommandLineInterface::lsrp(const std::vector<std::string>& args) {
     }
 
     auto start = std::chrono::high_resolution_clock::now();
-    std::string result;
     for (auto source : sources) {
-        result += "Source: " + source->getName() + '\n';
+        out_.text("Source: " + source->getName());
         auto table = network_.getLsrpTable(source);
-        result += getLsrpInfo(table);
-        result += getLsrpShortestPaths(source->getName(), network_.getShortestPaths(), table.back());
+        writeLsrpInfo(table);
+        writeLsrpShortestPaths(network_.getForwardingTable(), table.back());
     }
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
-    result += "Time elapsed: " + std::to_string(duration) + "ms";
-    return result;
+    return "Time elapsed: " + std::to_string(duration) + "ms";
 }
 
-std::string CommandLineInterface::getLsrpInfo(const std::vector<std::vector<int>>& table) const {
+void CommandLineInterface::writeLsrpInfo(const std::vector<std::vector<int>>& table) const {
     auto nodes = network_.getNodes();
+    if (out_.getFormat() != OutputWriter::Format::table) {
+        std::vector<std::string> header = {"Iter"};
+        for (auto node : nodes) {
+            header.push_back(node->getName());
+        }
+        out_.beginTable(OutputWriter::Style::plain, std::move(header));
+        for (unsigned i = 0; i < table.size(); ++i) {
+            std::vector<std::string> row = {std::to_string(i + 1)};
+            for (int cell : table[i]) {
+                row.push_back(std::to_string(cell));
+            }
+            out_.row(std::move(row));
+        }
+        out_.endTable();
+        return;
+    }
+
     int maxLen = 0;
     for (auto node : nodes) {
         maxLen = std::max<int>(maxLen, node->getName().size());
@@ -226,62 +312,122 @@ std::string CommandLineInterface::getLsrpInfo(const std::vector<std::vector<int>
         }
     }
 
-    std::string result;
     for (unsigned i = 0; i < table.size(); ++i) {
-        result += "Iter " + std::to_string(i + 1) + ":\n";
+        out_.text("Iter " + std::to_string(i + 1) + ":");
         std::string dests = "Dest ";
         for (unsigned j = 0; j < table[i].size(); ++j) {
             dests += utils::rjust(nodes[j]->getName(), maxLen) + " | ";
         }
         int lineLen = dests.size();
-        result += dests + '\n';
-        result += "Cost ";
+        out_.text(dests);
+        std::string costs = "Cost ";
         for (unsigned j = 0; j < table[i].size(); ++j) {
-            result += utils::rjust(std::to_string(table[i][j]), maxLen) + " | ";
+            costs += utils::rjust(std::to_string(table[i][j]), maxLen) + " | ";
         }
-        result += '\n';
-        result += utils::replicate('-', lineLen) + '\n';
+        out_.text(costs);
+        out_.text(utils::replicate('-', lineLen));
     }
-    return result;
 }
 
-std::string CommandLineInterface::getLsrpShortestPaths(const std::string& src,
-                                                       const std::unordered_map<std::string, std::vector<std::string>>& paths,
-                                                       const std::vector<int>& costs) const {
-    std::vector<std::vector<std::string>> table(paths.size() + 1, std::vector<std::string>(3));
-    table[0] = {"Path [s]->[d]", "Min-Cost", "Shortest-Path"};
+void CommandLineInterface::writeLsrpShortestPaths(const ForwardingTable& table, const std::vector<int>& costs) const {
     auto nodes = network_.getNodes();
+    const std::string& src = nodes[table.getSource()]->getName();
+    out_.beginTable(OutputWriter::Style::plain, {"Path [s]->[d]", "Min-Cost", "Shortest-Path"});
     for (unsigned i = 0; i < nodes.size(); ++i) {
-        if (nodes[i]->getName() == src) {
+        if (static_cast<int>(i) == table.getSource()) {
             continue;
         }
-        auto path = paths.at(nodes[i]->getName());
-        table[i + 1][0] = src + "->" + nodes[i]->getName();
-        table[i + 1][1] = std::to_string(costs[i]);
-        table[i + 1][2] = (costs[i] == -1) ? "None" : utils::join(path, "->");
+        out_.row({src + "->" + nodes[i]->getName(),
+                  std::to_string(costs[i]),
+                  (costs[i] == -1) ? "None" : getPathNames(table.getPath(i))});
     }
+    out_.endTable();
+}
 
-    int srcIndex = network_.getNodeIndex(src);
-    table.erase(table.begin() + srcIndex + 1);
-    int maxLen = 0;
-    for (auto& row : table) {
-        for (auto& cell : row) {
-            maxLen = std::max<int>(maxLen, cell.size());
+std::string CommandLineInterface::dvrp(const std::vector<std::string>& rawArgs) {
+    static const std::string usage = "Usage: dvrp <s> [--bf|--spfa|--simd]";
+    static const std::unordered_map<std::string, Network::DvrpEngine> engines = {
+        {"--bf", Network::DvrpEngine::bellmanFord},
+        {"--spfa", Network::DvrpEngine::spfa},
+        {"--simd", Network::DvrpEngine::vectorized},
+    };
+
+    std::vector<std::string> args = rawArgs;
+    Network::DvrpEngine engine = Network::DvrpEngine::bellmanFord;
+    if (!args.empty() && args.back().rfind("--", 0) == 0) {
+        auto it = engines.find(args.back());
+        if (it == engines.end()) {
+            return usage;
         }
+        engine = it->second;
+        args.pop_back();
+    }
+    if (args.size() > 1) {
+        return usage;
     }
 
-    std::string result;
-    for (auto& row : table) {
-        for (auto& cell : row) {
-            result += utils::center(cell, maxLen) + " | ";
+    std::vector<Node*> sources;
+    if (args.empty()) {
+        sources = network_.getNodes();
+    }
+    else {
+        if (!network_.doesNodeExist(args[0])) {
+            return "Source node does not exist";
         }
-        result += '\n';
+        sources.push_back(network_[args[0]]);
     }
-    return result;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto source : sources) {
+        out_.text("Source: " + source->getName());
+        auto table = network_.getDvrpTable(source, engine);
+        writeDvrpInfo(network_.getForwardingTable(), table);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+    return "Time elapsed: " + std::to_string(duration) + "ms";
+}
+
+void CommandLineInterface::writeDvrpInfo(const ForwardingTable& forwardingTable, const std::vector<int>& costs) const {
+    auto nodes = network_.getNodes();
+    out_.beginTable(OutputWriter::Style::grid, {"Dest", "Next Hop", "Dist", "Shortest-Path"});
+    for (unsigned i = 0; i < nodes.size(); ++i) {
+        if (costs[i] == -1) {
+            out_.row({nodes[i]->getName(), "None", std::to_string(costs[i]), "None"});
+        }
+        else {
+            out_.row({nodes[i]->getName(),
+                      nodes[forwardingTable.getNextHop(i)]->getName(),
+                      std::to_string(costs[i]),
+                      '[' + getPathNames(forwardingTable.getPath(i)) + ']'});
+        }
+    }
+    out_.endTable();
 }
 
-std::string CommandLineInterface::dvrp(const std::vector<std::string>& args) {
-    static const std::string usage = "Usage: dvrp <s>";
+std::string CommandLineInterface::delta(const std::vector<std::string>& rawArgs) {
+    static const std::string usage = "Usage: delta <s> [--delta=<d>] [--threads=<n>]";
+    delta_stepping::Options options;
+    std::vector<std::string> args;
+    for (const std::string& arg : rawArgs) {
+        if (arg.rfind("--", 0) != 0) {
+            args.push_back(arg);
+            continue;
+        }
+        auto option = utils::split(arg.substr(2), '=');
+        if (option.size() != 2 || !utils::isNumber(option[1])) {
+            return usage;
+        }
+        if (option[0] == "delta") {
+            options.delta = std::stoi(option[1]);
+        }
+        else if (option[0] == "threads") {
+            options.threads = std::stoi(option[1]);
+        }
+        else {
+            return usage;
+        }
+    }
     if (args.size() > 1) {
         return usage;
     }
@@ -298,53 +444,302 @@ std::string CommandLineInterface::dvrp(const std::vector<std::string>& args) {
     }
 
     auto start = std::chrono::high_resolution_clock::now();
-    std::string result;
     for (auto source : sources) {
-        result += "Source: " + source->getName() + '\n';
-        auto table = network_.getDvrpTable(source);
-        result += getDvrpInfo(network_.getShortestPaths(), table);
+        out_.text("Source: " + source->getName());
+        auto table = network_.getDeltaSteppingTable(source, options);
+        writeDvrpInfo(network_.getForwardingTable(), table);
     }
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
-    result += "Time elapsed: " + std::to_string(duration) + "ms";
-    return result;
+    return "Time elapsed: " + std::to_string(duration) + "ms";
 }
 
-std::string CommandLineInterface::getDvrpInfo(const std::unordered_map<std::string, std::vector<std::string>>& paths,
-                                              const std::vector<int>& costs) const {
-    std::vector<std::vector<std::string>> table(paths.size() + 1, std::vector<std::string>(4));
-    table[0] = {"Dest", "Next Hop", "Dist", "Shortest-Path"};
+std::string CommandLineInterface::apsp(const std::vector<std::string>& args) {
+    static const std::string usage = "Usage: apsp [--threads=<n>]";
+    int threads = 0;
+    if (args.size() > 1) {
+        return usage;
+    }
+    if (args.size() == 1) {
+        auto option = utils::split(args[0], '=');
+        if (option.size() != 2 || option[0] != "--threads" || !utils::isNumber(option[1])) {
+            return usage;
+        }
+        threads = std::stoi(option[1]);
+    }
+
+    if (!canRenderMatrix()) {
+        return getMatrixSkippedMessage();
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto matrix = network_.getAllPairsTable(threads);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+    writeMatrix(matrix);
+    return "Time elapsed: " + std::to_string(duration) + "ms";
+}
+
+std::string CommandLineInterface::ecmp(const std::vector<std::string>& args) {
+    static const std::string usage = "Usage: ecmp <s>";
+    if (args.size() != 1) {
+        return usage;
+    }
+    if (!network_.doesNodeExist(args[0])) {
+        return "Source node does not exist";
+    }
+
+    auto table = network_.getEcmpTable(network_[args[0]]);
     auto nodes = network_.getNodes();
+    out_.beginTable(OutputWriter::Style::grid, {"Dest", "Dist", "Next Hops (share)"});
     for (unsigned i = 0; i < nodes.size(); ++i) {
-        auto path = paths.at(nodes[i]->getName());
-        table[i + 1][0] = nodes[i]->getName();
-        table[i + 1][2] = std::to_string(costs[i]);
-        if (costs[i] == -1) {
-            table[i + 1][1] = "None";
-            table[i + 1][3] = "None";
+        if (static_cast<int>(i) == table.source) {
+            continue;
         }
-        else {
-            table[i + 1][1] = (path.size() == 1) ? path[0] : path[1];
-            table[i + 1][3] = '[' + utils::join(path, "->") + ']';
+        std::string hops;
+        for (int h = table.offsets[i]; h < table.offsets[i + 1]; ++h) {
+            if (h != table.offsets[i]) {
+                hops += ", ";
+            }
+            hops += nodes[table.nextHops[h]]->getName() + " (" + std::to_string(static_cast<int>(table.shares[h] * 100 + 0.5)) + "%)";
         }
+        out_.row({nodes[i]->getName(), std::to_string(table.distance[i]), hops.empty() ? "None" : hops});
     }
+    out_.endTable();
+    return "";
+}
 
-    int maxLen = 0;
-    for (auto& row : table) {
-        for (auto& cell : row) {
-            maxLen = std::max<int>(maxLen, cell.size());
+std::string CommandLineInterface::ksp(const std::vector<std::string>& args) {
+    static const std::string usage = "Usage: ksp <s> <d> <k>";
+    if (args.size() != 3) {
+        return usage;
+    }
+    if (!network_.doesNodeExist(args[0])) {
+        return "Source node does not exist";
+    }
+    if (!network_.doesNodeExist(args[1])) {
+        return "Destination node does not exist";
+    }
+    if (!utils::isNumber(args[2]) || std::stoi(args[2]) <= 0) {
+        return "k must be a positive number";
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto paths = network_.getKShortestPaths(network_[args[0]], network_[args[1]], std::stoi(args[2]));
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+    if (paths.empty()) {
+        return "No path found";
+    }
+
+    std::string result;
+    for (unsigned i = 0; i < paths.size(); ++i) {
+        result += '#' + std::to_string(i + 1) + " cost " + std::to_string(paths[i].cost) + ": " + getPathNames(paths[i].nodes) + '\n';
+    }
+    result += "Time elapsed: " + std::to_string(duration) + "ms";
+    return result;
+}
+
+std::string CommandLineInterface::route(const std::vector<std::string>& args) {
+    static const std::string usage = "Usage: route <s> <d> [--threads=<n>]";
+    if (args.size() < 2 || args.size() > 3) {
+        return usage;
+    }
+    int threads = 0;
+    if (args.size() == 3) {
+        auto option = utils::split(args[2], '=');
+        if (option.size() != 2 || option[0] != "--threads" || !utils::isNumber(option[1])) {
+            return usage;
         }
+        threads = std::stoi(option[1]);
+    }
+    if (!network_.doesNodeExist(args[0])) {
+        return "Source node does not exist";
+    }
+    if (!network_.doesNodeExist(args[1])) {
+        return "Destination node does not exist";
     }
 
     std::string result;
-    for (unsigned i = 0; i < table.size(); ++i) {
-        for (unsigned j = 0; j < table[i].size(); ++j) {
-            result += utils::center(table[i][j], maxLen) + " | ";
+    if (!network_.isHierarchyReady()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        network_.buildHierarchy(threads);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+        result += "Built the contraction hierarchy with " + std::to_string(network_.getShortcutCount()) +
+                  " shortcuts in " + std::to_string(duration) + "ms\n";
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto path = network_.getRoute(network_[args[0]], network_[args[1]]);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1000000.0;
+    if (path.nodes.empty()) {
+        result += "No path found\n";
+    }
+    else {
+        result += "Cost " + std::to_string(path.cost) + ": " + getPathNames(path.nodes) + '\n';
+    }
+    result += "Time elapsed: " + std::to_string(duration) + "ms";
+    return result;
+}
+
+std::string CommandLineInterface::flood(const std::vector<std::string>& rawArgs) {
+    static const std::string usage =
+        "Usage: flood [<s>] [--threads=<n>] [--delay=<t>] [--hold=<t>] [--max-hold=<t>] [--max-age=<t>]"
+        " [--fail=<a>-<b>@<t>] [--set=<a>-<b>-<w>@<t>]";
+    link_state::Options options;
+    std::unordered_map<std::string, int*> values = {
+        {"threads", &options.threads},
+        {"delay", &options.spfDelay},
+        {"hold", &options.spfHold},
+        {"max-hold", &options.spfMaxHold},
+        {"max-age", &options.maxAge},
+    };
+    std::vector<std::string> args;
+    for (const std::string& arg : rawArgs) {
+        if (arg.rfind("--", 0) != 0) {
+            args.push_back(arg);
+            continue;
+        }
+        auto option = utils::split(arg.substr(2), '=');
+        if (option.size() != 2) {
+            return usage;
+        }
+        if (option[0] == "fail" || option[0] == "set") {
+            link_state::LinkEvent event;
+            if (!parseLinkEvent(option[1], option[0] == "fail", event)) {
+                return usage;
+            }
+            options.events.push_back(event);
+            continue;
         }
-        result += '\n';
-        if (i == 0) {
-            result += utils::replicate('-', (maxLen + 3) * table[i].size()) + '\n';
+        auto it = values.find(option[0]);
+        if (it == values.end() || !utils::isNumber(option[1])) {
+            return usage;
+        }
+        *it->second = std::stoi(option[1]);
+    }
+    if (args.size() > 1) {
+        return usage;
+    }
+    if (options.spfDelay < 0 || options.spfHold <= 0 || options.maxAge <= 0) {
+        return "Delay must not be negative, hold and max age must be positive";
+    }
+    if (options.spfMaxHold < options.spfHold) {
+        return "Max hold must not be less than hold";
+    }
+    for (auto& event : options.events) {
+        if (event.source == -1 || event.destination == -1) {
+            return "Link event node does not exist";
+        }
+    }
+
+    Node* observed = nullptr;
+    if (!args.empty()) {
+        if (!network_.doesNodeExist(args[0])) {
+            return "Source node does not exist";
+        }
+        observed = network_[args[0]];
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto report = network_.simulateLinkState(observed, options);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+
+    if (observed == nullptr) {
+        writeFloodInfo(report);
+    }
+    else {
+        auto& router = report.routers[network_.getNodeIndex(args[0])];
+        out_.text("Router: " + args[0] + " (sent " + std::to_string(router.lsasSent) +
+                  ", received " + std::to_string(router.lsasReceived) +
+                  ", duplicates " + std::to_string(router.duplicates) +
+                  ", SPF runs " + std::to_string(router.spfRuns) +
+                  ", converged at tick " + std::to_string(router.convergedAt) + ")");
+        writeDvrpInfo(network_.getForwardingTable(), report.distance);
+    }
+
+    int slowest = -1;
+    double convergence = 0;
+    for (auto& router : report.routers) {
+        slowest = std::max(slowest, router.convergedAt);
+        convergence += router.convergedAt;
+    }
+    if (!report.routers.empty()) {
+        convergence /= report.routers.size();
+    }
+    std::string result = "LSAs originated: " + std::to_string(report.originated) +
+              ", transmitted: " + std::to_string(report.transmissions) +
+              " (" + std::to_string(report.bytes) + " bytes), duplicates: " + std::to_string(report.duplicates) + '\n';
+    result += "SPF runs: " + std::to_string(report.spfRuns) + '\n';
+    result += "Converged at tick " + std::to_string(slowest) + " (mean " + std::to_string(convergence) +
+              "), finished at tick " + std::to_string(report.finishedAt) + '\n';
+    result += "Time elapsed: " + std::to_string(duration) + "ms";
+    return result;
+}
+
+void CommandLineInterface::writeFloodInfo(const link_state::Report& report) const {
+    auto nodes = network_.getNodes();
+    out_.beginTable(OutputWriter::Style::grid, {"Router", "Sent", "Received", "Duplicates", "SPF Runs", "Converged"});
+    for (unsigned i = 0; i < report.routers.size(); ++i) {
+        auto& router = report.routers[i];
+        out_.row({nodes[i]->getName(),
+                  std::to_string(router.lsasSent),
+                  std::to_string(router.lsasReceived),
+                  std::to_string(router.duplicates),
+                  std::to_string(router.spfRuns),
+                  std::to_string(router.convergedAt)});
+    }
+    out_.endTable();
+}
+
+// Parses <a>-<b>@<t> for failures and <a>-<b>-<w>@<t> for weight changes.
+bool CommandLineInterface::parseLinkEvent(const std::string& arg, bool fail, link_state::LinkEvent& event) const {
+    auto parts = utils::split(arg, '@');
+    if (parts.size() != 2 || !utils::isNumber(parts[1])) {
+        return false;
+    }
+    auto link = utils::split(parts[0], '-');
+    if (link.size() != (fail ? 2u : 3u) || link[0] == link[1]) {
+        return false;
+    }
+    event.time = std::stoi(parts[1]);
+    event.source = network_.getNodeIndex(link[0]);
+    event.destination = network_.getNodeIndex(link[1]);
+    event.weight = 0;
+    if (!fail) {
+        if (!parseWeight(link[2], event.weight).empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Weights are below INF_DISTANCE, which the engines use for unreachable nodes,
+// so that no path cost can overflow. Returns the error or an empty string.
+std::string CommandLineInterface::parseWeight(const std::string& str, int& weight) const {
+    if (!utils::isNumber(str)) {
+        return "Weight must be a number";
+    }
+    if (str[0] == '-' || str.find_first_not_of('0') == std::string::npos) {
+        return "Weight must be positive";
+    }
+    if (str.size() - str.find_first_not_of('0') > 10 || std::stoll(str) >= INF_DISTANCE) {
+        return "Weight must be less than " + std::to_string(INF_DISTANCE);
+    }
+    weight = std::stoi(str);
+    return "";
+}
+
+std::string CommandLineInterface::getPathNames(const std::vector<int>& path) const {
+    std::string result;
+    for (unsigned i = 0; i < path.size(); ++i) {
+        if (i != 0) {
+            result += "->";
         }
+        result += network_[path[i]]->getName();
     }
     return result;
 }
@@ -2,21 +2,29 @@
 #define COMMAND_LINE_INTERFACE_HPP_INCLUDE
 
 #include <functional>
+#include <istream>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "network.hpp"
+#include "output_writer.hpp"
 
 class CommandLineInterface {
 public:
-    CommandLineInterface(Network& network);
+    CommandLineInterface(Network& network, OutputWriter& out);
     ~CommandLineInterface() = default;
 
-    void run();
+    // Reads commands until the end of input or exit. The prompt is only shown
+    // and the output only flushed after every command in interactive mode.
+    void run(std::istream& input, bool interactive);
 
 private:
+    // Larger topologies are only printed as matrices in the csv and binary formats.
+    static constexpr unsigned MAX_RENDERED_NODES = 128;
+
     Network& network_;
+    OutputWriter& out_;
     std::unordered_map<std::string, std::function<std::string(const std::vector<std::string>&)>> commands_;
 
     std::string help(const std::vector<std::string>& args);
@@ -24,16 +32,30 @@ private:
     std::string show(const std::vector<std::string>& args);
     std::string modify(const std::vector<std::string>& args);
     std::string remove(const std::vector<std::string>& args);
+    std::string load(const std::vector<std::string>& args);
+    std::string save(const std::vector<std::string>& args);
 
     std::string lsrp(const std::vector<std::string>& args);
-    std::string getLsrpInfo(const std::vector<std::vector<int>>& table) const;
-    std::string getLsrpShortestPaths(const std::string& src,
-                                     const std::unordered_map<std::string, std::vector<std::string>>& paths,
-                                     const std::vector<int>& costs) const;
+    void writeLsrpInfo(const std::vector<std::vector<int>>& table) const;
+    void writeLsrpShortestPaths(const ForwardingTable& table, const std::vector<int>& costs) const;
 
     std::string dvrp(const std::vector<std::string>& args);
-    std::string getDvrpInfo(const std::unordered_map<std::string, std::vector<std::string>>& paths,
-                            const std::vector<int>& costs) const;
+    void writeDvrpInfo(const ForwardingTable& forwardingTable, const std::vector<int>& costs) const;
+
+    std::string delta(const std::vector<std::string>& args);
+    std::string apsp(const std::vector<std::string>& args);
+    bool canRenderMatrix() const;
+    std::string getMatrixSkippedMessage() const;
+    void writeMatrix(const DistanceMatrix& matrix) const;
+    std::string ecmp(const std::vector<std::string>& args);
+    std::string ksp(const std::vector<std::string>& args);
+    std::string route(const std::vector<std::string>& args);
+    std::string flood(const std::vector<std::string>& args);
+    void writeFloodInfo(const link_state::Report& report) const;
+    bool parseLinkEvent(const std::string& arg, bool fail, link_state::LinkEvent& event) const;
+
+    std::string parseWeight(const std::string& str, int& weight) const;
+    std::string getPathNames(const std::vector<int>& path) const;
 };
 
 #endif // COMMAND_LINE_INTERFACE_HPP_INCLUDE
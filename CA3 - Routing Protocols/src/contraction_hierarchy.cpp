@@ -0,0 +1,434 @@
+#include "contraction_hierarchy.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+constexpr int CHUNK_SIZE = 16;
+// Priorities only need an estimate of the shortcut count, so their searches are cut earlier.
+constexpr int PRIORITY_SETTLE_LIMIT = 50;
+constexpr int CONTRACTION_SETTLE_LIMIT = 500;
+// Above this degree a priority assumes every pair of neighbors needs a shortcut, which
+// keeps hubs for the end of the order without searching around them after every round.
+constexpr int ESTIMATED_DEGREE = 32;
+
+struct Arc {
+    int target;
+    int weight;
+    int middle;
+};
+
+struct Shortcut {
+    int source;
+    int target;
+    int weight;
+};
+
+// Calls fn(worker, i) for every i in [0, count), handing out chunks of indices.
+template <typename Function>
+void parallelFor(int count, int threads, Function fn) {
+    std::atomic<int> next{0};
+    auto work = [&](int worker) {
+        while (true) {
+            int begin = next.fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+            if (begin >= count) {
+                return;
+            }
+            int end = std::min(count, begin + CHUNK_SIZE);
+            for (int i = begin; i < end; ++i) {
+                fn(worker, i);
+            }
+        }
+    };
+
+    threads = std::min(threads, (count + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(work, t);
+    }
+    work(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+// Dijkstra from one neighbor of the node being contracted which never enters that node.
+// It stops once every target is settled, past the largest distance of interest or after
+// a fixed number of settled nodes, so a missed witness only costs an unneeded shortcut.
+class WitnessSearch {
+public:
+    WitnessSearch(int nodeCount) : distance_(nodeCount, INF_DISTANCE), targetStamp_(nodeCount, 0) {}
+
+    void run(const std::vector<std::vector<Arc>>& graph, int source, int avoided, const std::vector<int>& targets,
+             int limit, int settleLimit) {
+        for (int v : touched_) {
+            distance_[v] = INF_DISTANCE;
+        }
+        touched_.clear();
+        ++stamp_;
+        for (int target : targets) {
+            targetStamp_[target] = stamp_;
+        }
+        int remainingTargets = targets.size();
+
+        distance_[source] = 0;
+        touched_.push_back(source);
+        MinHeap heap;
+        heap.push({source, 0});
+        int settled = 0;
+        while (!heap.empty()) {
+            NodeDistance top = heap.top();
+            heap.pop();
+            if (top.distance > distance_[top.node]) {
+                continue;
+            }
+            if (top.distance > limit || ++settled > settleLimit) {
+                break;
+            }
+            if (targetStamp_[top.node] == stamp_ && --remainingTargets == 0) {
+                break;
+            }
+            for (const Arc& arc : graph[top.node]) {
+                if (arc.target == avoided) {
+                    continue;
+                }
+                int candidate = top.distance + arc.weight;
+                if (candidate < distance_[arc.target]) {
+                    if (distance_[arc.target] == INF_DISTANCE) {
+                        touched_.push_back(arc.target);
+                    }
+                    distance_[arc.target] = candidate;
+                    heap.push({arc.target, candidate});
+                }
+            }
+        }
+    }
+
+    int getDistance(int node) const { return distance_[node]; }
+
+private:
+    std::vector<int> distance_;
+    std::vector<int> touched_;
+    std::vector<unsigned> targetStamp_;
+    unsigned stamp_ = 0;
+};
+
+class Builder {
+public:
+    Builder(const CsrGraph& csr, int threads)
+        : threads_(threads),
+          graph_(csr.nodeCount()),
+          priority_(csr.nodeCount(), 0),
+          level_(csr.nodeCount(), 0),
+          deletedNeighbors_(csr.nodeCount(), 0) {
+        for (int u = 0; u < csr.nodeCount(); ++u) {
+            for (int e = csr.offsets[u]; e < csr.offsets[u + 1]; ++e) {
+                if (csr.weights[e] < 0) {
+                    throw std::runtime_error("Contraction hierarchies need non-negative weights");
+                }
+                addArc(u, {csr.targets[e], csr.weights[e], -1});
+            }
+        }
+        for (int t = 0; t < threads; ++t) {
+            searches_.emplace_back(csr.nodeCount());
+        }
+    }
+
+    // Fills the rank of every node and its arcs to the higher ranked nodes.
+    void contractAll(std::vector<int>& rank, std::vector<std::vector<Arc>>& upward) {
+        int n = graph_.size();
+        rank.assign(n, -1);
+        upward.assign(n, {});
+        std::vector<int> remaining(n);
+        std::iota(remaining.begin(), remaining.end(), 0);
+        std::vector<char> dirty(n, 0);
+        std::vector<char> selected;
+        std::vector<int> round;
+        std::vector<std::vector<Shortcut>> shortcuts;
+        int nextRank = 0;
+
+        parallelFor(n, threads_, [&](int worker, int u) {
+            updatePriority(u, searches_[worker]);
+        });
+
+        // Priorities of nodes whose neighborhood changed are only refreshed when
+        // they are selected; a node whose priority grew waits for a later round.
+        while (!remaining.empty()) {
+            int count = remaining.size();
+            selected.assign(count, 0);
+            parallelFor(count, threads_, [&](int, int i) {
+                selected[i] = isLocalMinimum(remaining[i]);
+            });
+            round.clear();
+            for (int i = 0; i < count; ++i) {
+                if (selected[i]) {
+                    round.push_back(remaining[i]);
+                }
+            }
+
+            selected.assign(round.size(), 1);
+            parallelFor(round.size(), threads_, [&](int worker, int i) {
+                int u = round[i];
+                if (dirty[u]) {
+                    int previous = priority_[u];
+                    updatePriority(u, searches_[worker]);
+                    dirty[u] = 0;
+                    selected[i] = priority_[u] <= previous;
+                }
+            });
+            int kept = 0;
+            for (unsigned i = 0; i < round.size(); ++i) {
+                if (selected[i]) {
+                    round[kept++] = round[i];
+                }
+            }
+            round.resize(kept);
+
+            shortcuts.assign(round.size(), {});
+            parallelFor(round.size(), threads_, [&](int worker, int i) {
+                simulate(round[i], searches_[worker], &shortcuts[i]);
+            });
+
+            // Nodes of a round share no neighbor, so applying them in id order
+            // gives the same graph as any other order.
+            for (unsigned i = 0; i < round.size(); ++i) {
+                int u = round[i];
+                rank[u] = nextRank++;
+                for (const Arc& arc : graph_[u]) {
+                    removeArc(arc.target, u);
+                    ++deletedNeighbors_[arc.target];
+                    level_[arc.target] = std::max(level_[arc.target], level_[u] + 1);
+                    dirty[arc.target] = 1;
+                }
+                for (const Shortcut& shortcut : shortcuts[i]) {
+                    addArc(shortcut.source, {shortcut.target, shortcut.weight, u});
+                    addArc(shortcut.target, {shortcut.source, shortcut.weight, u});
+                }
+                upward[u] = std::move(graph_[u]);
+                graph_[u] = {};
+            }
+            remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&rank](int u) {
+                                return rank[u] != -1;
+                            }),
+                            remaining.end());
+        }
+    }
+
+private:
+    int threads_;
+    std::vector<std::vector<Arc>> graph_;
+    std::vector<int> priority_;
+    std::vector<int> level_;
+    std::vector<int> deletedNeighbors_;
+    std::vector<WitnessSearch> searches_;
+
+    void updatePriority(int u, WitnessSearch& search) {
+        int degree = graph_[u].size();
+        int shortcuts = degree > ESTIMATED_DEGREE ? degree * (degree - 1) / 2 : simulate(u, search, nullptr);
+        priority_[u] = 2 * (shortcuts - degree) + deletedNeighbors_[u] + level_[u];
+    }
+
+    bool precedes(int a, int b) const {
+        return priority_[a] < priority_[b] || (priority_[a] == priority_[b] && a < b);
+    }
+
+    bool isLocalMinimum(int u) const {
+        for (const Arc& arc : graph_[u]) {
+            if (precedes(arc.target, u)) {
+                return false;
+            }
+            for (const Arc& next : graph_[arc.target]) {
+                if (next.target != u && precedes(next.target, u)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Counts (and optionally collects) the shortcuts needed to contract u.
+    int simulate(int u, WitnessSearch& search, std::vector<Shortcut>* shortcuts) const {
+        const auto& arcs = graph_[u];
+        std::vector<int> targets;
+        int count = 0;
+        for (unsigned i = 0; i + 1 < arcs.size(); ++i) {
+            int limit = 0;
+            targets.clear();
+            for (unsigned j = i + 1; j < arcs.size(); ++j) {
+                limit = std::max(limit, arcs[i].weight + arcs[j].weight);
+                targets.push_back(arcs[j].target);
+            }
+            search.run(graph_, arcs[i].target, u, targets, limit,
+                       shortcuts == nullptr ? PRIORITY_SETTLE_LIMIT : CONTRACTION_SETTLE_LIMIT);
+            for (unsigned j = i + 1; j < arcs.size(); ++j) {
+                int weight = arcs[i].weight + arcs[j].weight;
+                if (search.getDistance(arcs[j].target) > weight) {
+                    ++count;
+                    if (shortcuts != nullptr) {
+                        shortcuts->push_back({arcs[i].target, arcs[j].target, weight});
+                    }
+                }
+            }
+        }
+        return count;
+    }
+
+    void addArc(int u, const Arc& arc) {
+        for (Arc& existing : graph_[u]) {
+            if (existing.target == arc.target) {
+                if (arc.weight < existing.weight) {
+                    existing = arc;
+                }
+                return;
+            }
+        }
+        graph_[u].push_back(arc);
+    }
+
+    void removeArc(int u, int target) {
+        auto& arcs = graph_[u];
+        arcs.erase(std::find_if(arcs.begin(), arcs.end(), [target](const Arc& arc) {
+            return arc.target == target;
+        }));
+    }
+};
+
+} // namespace
+
+ContractionHierarchy::ContractionHierarchy(const CsrGraph& csr, int threads) {
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<int> rank;
+    std::vector<std::vector<Arc>> upward;
+    Builder(csr, threads).contractAll(rank, upward);
+
+    int n = csr.nodeCount();
+    offsets_.assign(n + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        offsets_[u + 1] = offsets_[u] + upward[u].size();
+        for (const Arc& arc : upward[u]) {
+            targets_.push_back(arc.target);
+            weights_.push_back(arc.weight);
+            middles_.push_back(arc.middle);
+            shortcuts_ += arc.middle != -1;
+        }
+    }
+    for (int d = 0; d < 2; ++d) {
+        distance_[d].assign(n, INF_DISTANCE);
+        parent_[d].assign(n, -1);
+        parentArc_[d].assign(n, -1);
+    }
+}
+
+int ContractionHierarchy::getShortcutCount() const {
+    return shortcuts_;
+}
+
+WeightedPath ContractionHierarchy::getPath(int src, int dst, RoutingStats& stats) {
+    if (src == dst) {
+        return {0, {src}};
+    }
+
+    MinHeap heaps[2];
+    int ends[2] = {src, dst};
+    for (int d = 0; d < 2; ++d) {
+        distance_[d][ends[d]] = 0;
+        touched_.push_back(ends[d]);
+        heaps[d].push({ends[d], 0});
+        ++stats.heapOperations;
+    }
+
+    // Both searches only go up the hierarchy and the shortest path has a single
+    // highest node, so a search may stop once its smallest key reaches the best meeting.
+    int best = INF_DISTANCE;
+    int meet = -1;
+    while (true) {
+        int dir = -1;
+        for (int d = 0; d < 2; ++d) {
+            if (!heaps[d].empty() && heaps[d].top().distance < best &&
+                (dir == -1 || heaps[d].top().distance < heaps[dir].top().distance)) {
+                dir = d;
+            }
+        }
+        if (dir == -1) {
+            break;
+        }
+
+        NodeDistance top = heaps[dir].top();
+        heaps[dir].pop();
+        ++stats.heapOperations;
+        auto& distance = distance_[dir];
+        if (top.distance > distance[top.node]) {
+            continue;
+        }
+        int other = distance_[1 - dir][top.node];
+        if (other != INF_DISTANCE && top.distance + other < best) {
+            best = top.distance + other;
+            meet = top.node;
+        }
+        for (int e = offsets_[top.node]; e < offsets_[top.node + 1]; ++e) {
+            ++stats.relaxations;
+            int v = targets_[e];
+            int candidate = top.distance + weights_[e];
+            if (candidate < distance[v]) {
+                if (distance[v] == INF_DISTANCE) {
+                    touched_.push_back(v);
+                }
+                distance[v] = candidate;
+                parent_[dir][v] = top.node;
+                parentArc_[dir][v] = e;
+                heaps[dir].push({v, candidate});
+                ++stats.heapOperations;
+            }
+        }
+    }
+
+    WeightedPath result{-1, {}};
+    if (meet != -1) {
+        result.cost = best;
+        std::vector<int> chain;
+        for (int v = meet; v != src; v = parent_[0][v]) {
+            chain.push_back(v);
+        }
+        result.nodes.push_back(src);
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            appendUnpacked(parent_[0][*it], *it, middles_[parentArc_[0][*it]], result.nodes);
+        }
+        for (int v = meet; v != dst; v = parent_[1][v]) {
+            appendUnpacked(v, parent_[1][v], middles_[parentArc_[1][v]], result.nodes);
+        }
+    }
+
+    for (int v : touched_) {
+        distance_[0][v] = INF_DISTANCE;
+        distance_[1][v] = INF_DISTANCE;
+    }
+    touched_.clear();
+    return result;
+}
+
+// The middle node of a shortcut was contracted before both of its ends,
+// so both halves are arcs out of the middle node.
+int ContractionHierarchy::findMiddle(int low, int high) const {
+    for (int e = offsets_[low]; e < offsets_[low + 1]; ++e) {
+        if (targets_[e] == high) {
+            return middles_[e];
+        }
+    }
+    return -1;
+}
+
+// Appends the nodes after from up to and including to.
+void ContractionHierarchy::appendUnpacked(int from, int to, int middle, std::vector<int>& path) const {
+    if (middle == -1) {
+        path.push_back(to);
+        return;
+    }
+    appendUnpacked(from, middle, findMiddle(middle, from), path);
+    appendUnpacked(middle, to, findMiddle(middle, to), path);
+}
@@ -0,0 +1,43 @@
+#ifndef CONTRACTION_HIERARCHY_HPP_INCLUDE
+#define CONTRACTION_HIERARCHY_HPP_INCLUDE
+
+#include <vector>
+
+#include "csr_graph.hpp"
+#include "multipath.hpp"
+#include "shortest_path.hpp"
+
+// Contraction hierarchy over an undirected CSR graph for point-to-point queries.
+// Nodes are contracted in rounds: every node whose priority is the smallest in its
+// two-hop neighborhood is contracted in parallel with the others of its round.
+class ContractionHierarchy {
+public:
+    ContractionHierarchy() = default;
+    ContractionHierarchy(const CsrGraph& csr, int threads = 0);
+
+    int getShortcutCount() const;
+
+    // Bidirectional upward search, returns a cost of -1 and no nodes when dst is unreachable.
+    WeightedPath getPath(int src, int dst, RoutingStats& stats);
+
+private:
+    int shortcuts_ = 0;
+
+    // Arcs from every node to its higher ranked neighbors. middle is the node a
+    // shortcut skips (-1 for links of the topology).
+    std::vector<int> offsets_;
+    std::vector<int> targets_;
+    std::vector<int> weights_;
+    std::vector<int> middles_;
+
+    // Query state, reset through touched_ so a query only costs what it visits.
+    std::vector<int> distance_[2];
+    std::vector<int> parent_[2];
+    std::vector<int> parentArc_[2];
+    std::vector<int> touched_;
+
+    int findMiddle(int low, int high) const;
+    void appendUnpacked(int from, int to, int middle, std::vector<int>& path) const;
+};
+
+#endif // CONTRACTION_HIERARCHY_HPP_INCLUDE
@@ -0,0 +1,49 @@
+#include "csr_graph.hpp"
+
+CsrGraph buildCsrGraph(int nodeCount, const std::vector<CsrEdge>& edges, int& duplicates) {
+    CsrGraph csr;
+    csr.offsets.assign(nodeCount + 1, 0);
+    for (auto& edge : edges) {
+        ++csr.offsets[edge.source + 1];
+        ++csr.offsets[edge.destination + 1];
+    }
+    for (int i = 0; i < nodeCount; ++i) {
+        csr.offsets[i + 1] += csr.offsets[i];
+    }
+
+    std::vector<int> cursor(csr.offsets.begin(), csr.offsets.end() - 1);
+    csr.targets.resize(csr.offsets.back());
+    csr.weights.resize(csr.offsets.back());
+    for (auto& edge : edges) {
+        int pos = cursor[edge.source]++;
+        csr.targets[pos] = edge.destination;
+        csr.weights[pos] = edge.weight;
+        pos = cursor[edge.destination]++;
+        csr.targets[pos] = edge.source;
+        csr.weights[pos] = edge.weight;
+    }
+
+    // Keep the first occurrence of every link, like Network::addEdge does.
+    std::vector<int> seen(nodeCount, -1);
+    int out = 0;
+    int begin = 0;
+    for (int u = 0; u < nodeCount; ++u) {
+        int end = csr.offsets[u + 1];
+        for (int e = begin; e < end; ++e) {
+            int v = csr.targets[e];
+            if (seen[v] == u) {
+                continue;
+            }
+            seen[v] = u;
+            csr.targets[out] = v;
+            csr.weights[out] = csr.weights[e];
+            ++out;
+        }
+        begin = end;
+        csr.offsets[u + 1] = out;
+    }
+    duplicates = (static_cast<int>(csr.targets.size()) - out) / 2;
+    csr.targets.resize(out);
+    csr.weights.resize(out);
+    return csr;
+}
@@ -0,0 +1,30 @@
+#ifndef CSR_GRAPH_HPP_INCLUDE
+#define CSR_GRAPH_HPP_INCLUDE
+
+#include <limits>
+#include <vector>
+
+constexpr int INF_DISTANCE = std::numeric_limits<int>::max() / 2;
+
+// Compressed sparse row snapshot of the network.
+// Edges of node i are targets[offsets[i]] .. targets[offsets[i + 1] - 1].
+struct CsrGraph {
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<int> weights;
+
+    int nodeCount() const { return offsets.empty() ? 0 : static_cast<int>(offsets.size()) - 1; }
+    int edgeCount() const { return static_cast<int>(targets.size()); }
+};
+
+struct CsrEdge {
+    int source;
+    int destination;
+    int weight;
+};
+
+// Builds an undirected CSR graph keeping the first occurrence of every link.
+// The number of dropped repeated links is stored in duplicates.
+CsrGraph buildCsrGraph(int nodeCount, const std::vector<CsrEdge>& edges, int& duplicates);
+
+#endif // CSR_GRAPH_HPP_INCLUDE
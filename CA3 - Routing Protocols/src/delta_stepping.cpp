@@ -0,0 +1,240 @@
+#include "delta_stepping.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "barrier.hpp"
+
+namespace delta_stepping {
+
+namespace {
+
+constexpr int CHUNK_SIZE = 64;
+constexpr uint64_t NO_PARENT = 0xFFFFFFFF;
+
+// Distance in the high half and parent in the low half, so a single atomic
+// minimum updates both and equal distances keep the smaller parent id.
+uint64_t pack(int distance, int parent) {
+    return (static_cast<uint64_t>(distance) << 32) | static_cast<uint32_t>(parent);
+}
+
+int unpackDistance(uint64_t value) {
+    return static_cast<int>(value >> 32);
+}
+
+int unpackParent(uint64_t value) {
+    uint64_t parent = value & NO_PARENT;
+    return parent == NO_PARENT ? -1 : static_cast<int>(parent);
+}
+
+struct alignas(64) WorkRange {
+    std::atomic<int> next{0};
+    int end = 0;
+};
+
+struct alignas(64) WorkerState {
+    std::vector<int> updated;
+    long long relaxations = 0;
+};
+
+class Solver {
+public:
+    Solver(const CsrGraph& csr, int src, int delta, int threads)
+        : csr_(csr),
+          delta_(delta),
+          threads_(threads),
+          packed_(new std::atomic<uint64_t>[csr.nodeCount()]),
+          ranges_(threads),
+          workers_(threads),
+          barrier_(threads),
+          frontierEpoch_(csr.nodeCount(), -1),
+          settledEpoch_(csr.nodeCount(), -1) {
+        for (int i = 0; i < csr.nodeCount(); ++i) {
+            packed_[i].store(pack(INF_DISTANCE, -1), std::memory_order_relaxed);
+        }
+        packed_[src].store(pack(0, -1), std::memory_order_relaxed);
+        insert(src);
+    }
+
+    void solve(std::vector<int>& distance, std::vector<int>& parent, RoutingStats& stats) {
+        prepareNextPhase();
+        std::vector<std::thread> threads;
+        for (int t = 1; t < threads_; ++t) {
+            threads.emplace_back(&Solver::work, this, t);
+        }
+        work(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (int i = 0; i < csr_.nodeCount(); ++i) {
+            uint64_t value = packed_[i].load(std::memory_order_relaxed);
+            distance[i] = unpackDistance(value);
+            parent[i] = unpackParent(value);
+        }
+        for (auto& worker : workers_) {
+            stats.relaxations += worker.relaxations;
+        }
+        stats.heapOperations += bucketInsertions_;
+    }
+
+private:
+    const CsrGraph& csr_;
+    int delta_;
+    int threads_;
+    std::unique_ptr<std::atomic<uint64_t>[]> packed_;
+    std::vector<WorkRange> ranges_;
+    std::vector<WorkerState> workers_;
+    Barrier barrier_;
+
+    // Only touched by thread 0 between the two barriers of a phase.
+    std::vector<std::vector<int>> buckets_;
+    size_t currentBucket_ = 0;
+    std::vector<int> frontier_;
+    std::vector<int> settled_;
+    std::vector<int> frontierEpoch_;
+    std::vector<int> settledEpoch_;
+    int phase_ = 0;
+    bool heavyPhase_ = false;
+    bool done_ = false;
+    long long bucketInsertions_ = 0;
+
+    int distanceOf(int node) const {
+        return unpackDistance(packed_[node].load(std::memory_order_relaxed));
+    }
+
+    void insert(int node) {
+        size_t bucket = distanceOf(node) / delta_;
+        if (bucket >= buckets_.size()) {
+            buckets_.resize(bucket + 1);
+        }
+        buckets_[bucket].push_back(node);
+        ++bucketInsertions_;
+    }
+
+    void work(int tid) {
+        while (true) {
+            barrier_.wait();
+            if (done_) {
+                return;
+            }
+            const std::vector<int>& items = heavyPhase_ ? settled_ : frontier_;
+            for (int i = 0; i < threads_; ++i) {
+                WorkRange& range = ranges_[(tid + i) % threads_];
+                while (true) {
+                    int begin = range.next.fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+                    if (begin >= range.end) {
+                        break;
+                    }
+                    int end = std::min(begin + CHUNK_SIZE, range.end);
+                    for (int k = begin; k < end; ++k) {
+                        relax(tid, items[k], heavyPhase_);
+                    }
+                }
+            }
+            barrier_.wait();
+            if (tid == 0) {
+                prepareNextPhase();
+            }
+        }
+    }
+
+    void relax(int tid, int u, bool heavy) {
+        WorkerState& worker = workers_[tid];
+        int du = distanceOf(u);
+        for (int e = csr_.offsets[u]; e < csr_.offsets[u + 1]; ++e) {
+            int w = csr_.weights[e];
+            if ((w > delta_) != heavy) {
+                continue;
+            }
+            ++worker.relaxations;
+            int v = csr_.targets[e];
+            uint64_t candidate = pack(du + w, u);
+            uint64_t current = packed_[v].load(std::memory_order_relaxed);
+            while (candidate < current) {
+                if (packed_[v].compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+                    worker.updated.push_back(v);
+                    break;
+                }
+            }
+        }
+    }
+
+    void prepareNextPhase() {
+        for (auto& worker : workers_) {
+            for (int node : worker.updated) {
+                insert(node);
+            }
+            worker.updated.clear();
+        }
+
+        // Heavy edges always leave the current bucket, so it is final now.
+        if (heavyPhase_) {
+            settled_.clear();
+            ++currentBucket_;
+        }
+
+        ++phase_;
+        frontier_.clear();
+        heavyPhase_ = false;
+        while (currentBucket_ < buckets_.size()) {
+            // Nodes can sit in a bucket more than once or be stale after moving
+            // to a lower bucket, only the entries matching their distance count.
+            std::vector<int> bucket;
+            bucket.swap(buckets_[currentBucket_]);
+            for (int node : bucket) {
+                if (static_cast<size_t>(distanceOf(node) / delta_) != currentBucket_ || frontierEpoch_[node] == phase_) {
+                    continue;
+                }
+                frontierEpoch_[node] = phase_;
+                frontier_.push_back(node);
+                if (settledEpoch_[node] != static_cast<int>(currentBucket_)) {
+                    settledEpoch_[node] = currentBucket_;
+                    settled_.push_back(node);
+                }
+            }
+            if (!frontier_.empty()) {
+                break;
+            }
+            if (!settled_.empty()) {
+                heavyPhase_ = true;
+                break;
+            }
+            ++currentBucket_;
+        }
+
+        done_ = frontier_.empty() && !heavyPhase_;
+        const std::vector<int>& items = heavyPhase_ ? settled_ : frontier_;
+        long long count = items.size();
+        for (int t = 0; t < threads_; ++t) {
+            ranges_[t].next.store(count * t / threads_, std::memory_order_relaxed);
+            ranges_[t].end = count * (t + 1) / threads_;
+        }
+    }
+};
+
+} // namespace
+
+void run(const CsrGraph& csr, int src, const Options& options,
+         std::vector<int>& distance, std::vector<int>& parent, RoutingStats& stats) {
+    int delta = options.delta;
+    if (delta <= 0) {
+        long long total = 0;
+        for (int w : csr.weights) {
+            total += w;
+        }
+        delta = csr.edgeCount() == 0 ? 1 : std::max<long long>(1, total / csr.edgeCount());
+    }
+    int threads = options.threads;
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    Solver solver(csr, src, delta, threads);
+    solver.solve(distance, parent, stats);
+}
+
+} // namespace delta_stepping
@@ -0,0 +1,24 @@
+#ifndef DELTA_STEPPING_HPP_INCLUDE
+#define DELTA_STEPPING_HPP_INCLUDE
+
+#include <vector>
+
+#include "csr_graph.hpp"
+#include "shortest_path.hpp"
+
+namespace delta_stepping {
+
+struct Options {
+    int delta = 0;   // bucket width, 0 picks the average edge weight
+    int threads = 0; // 0 uses every hardware thread
+};
+
+// Parallel single-source shortest paths. distance and parent are filled in the
+// same format as the other engines (INF_DISTANCE and -1 for unreachable nodes).
+// Heap operations in stats count the bucket insertions.
+void run(const CsrGraph& csr, int src, const Options& options,
+         std::vector<int>& distance, std::vector<int>& parent, RoutingStats& stats);
+
+} // namespace delta_stepping
+
+#endif // DELTA_STEPPING_HPP_INCLUDE
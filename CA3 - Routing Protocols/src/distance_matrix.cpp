@@ -0,0 +1,42 @@
+#include "distance_matrix.hpp"
+
+#include <algorithm>
+#include <new>
+
+DistanceMatrix::DistanceMatrix(int size)
+    : size_(size),
+      stride_((size + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE) {
+    size_t cells = static_cast<size_t>(stride_) * stride_;
+    if (cells == 0) {
+        return;
+    }
+    data_.reset(static_cast<int*>(std::aligned_alloc(64, cells * sizeof(int))));
+    if (!data_) {
+        throw std::bad_alloc();
+    }
+    std::fill(data_.get(), data_.get() + cells, INF_DISTANCE);
+}
+
+int DistanceMatrix::size() const {
+    return size_;
+}
+
+int DistanceMatrix::stride() const {
+    return stride_;
+}
+
+int* DistanceMatrix::row(int i) {
+    return data_.get() + static_cast<size_t>(i) * stride_;
+}
+
+const int* DistanceMatrix::row(int i) const {
+    return data_.get() + static_cast<size_t>(i) * stride_;
+}
+
+int& DistanceMatrix::at(int i, int j) {
+    return row(i)[j];
+}
+
+int DistanceMatrix::at(int i, int j) const {
+    return row(i)[j];
+}
@@ -0,0 +1,35 @@
+#ifndef DISTANCE_MATRIX_HPP_INCLUDE
+#define DISTANCE_MATRIX_HPP_INCLUDE
+
+#include <cstdlib>
+#include <memory>
+
+#include "csr_graph.hpp"
+
+// Dense row-major matrix of distances with INF_DISTANCE for missing links.
+// Rows are padded to a multiple of BLOCK_SIZE and start on a cache line.
+class DistanceMatrix {
+public:
+    static constexpr int BLOCK_SIZE = 64;
+
+    DistanceMatrix(int size = 0);
+
+    int size() const;
+    int stride() const;
+
+    int* row(int i);
+    const int* row(int i) const;
+    int& at(int i, int j);
+    int at(int i, int j) const;
+
+private:
+    struct FreeDeleter {
+        void operator()(int* data) const { std::free(data); }
+    };
+
+    int size_;
+    int stride_;
+    std::unique_ptr<int[], FreeDeleter> data_;
+};
+
+#endif // DISTANCE_MATRIX_HPP_INCLUDE
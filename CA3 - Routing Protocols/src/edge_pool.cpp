@@ -0,0 +1,35 @@
+#include "edge_pool.hpp"
+
+static_assert(sizeof(Edge) == 12, "Edge should stay three ints");
+
+int EdgePool::allocate(int destination, int weight) {
+    if (freeHead_ == NONE) {
+        edges_.push_back({destination, weight, NONE});
+        return edges_.size() - 1;
+    }
+    int handle = freeHead_;
+    freeHead_ = edges_[handle].next;
+    --freeCount_;
+    edges_[handle] = {destination, weight, NONE};
+    return handle;
+}
+
+void EdgePool::release(int handle) {
+    edges_[handle].next = freeHead_;
+    freeHead_ = handle;
+    ++freeCount_;
+}
+
+void EdgePool::reserve(int count) {
+    edges_.reserve(count);
+}
+
+void EdgePool::clear() {
+    std::vector<Edge>().swap(edges_);
+    freeHead_ = NONE;
+    freeCount_ = 0;
+}
+
+int EdgePool::size() const {
+    return edges_.size() - freeCount_;
+}
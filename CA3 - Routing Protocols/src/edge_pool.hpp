@@ -0,0 +1,36 @@
+#ifndef EDGE_POOL_HPP_INCLUDE
+#define EDGE_POOL_HPP_INCLUDE
+
+#include <vector>
+
+// One direction of a link. Edges of a node form a list through next, and the
+// destination is a node id, so an edge takes 12 bytes.
+struct Edge {
+    int destination;
+    int weight;
+    int next;
+};
+
+// Flat edge storage addressed by integer handles. Released edges are kept in a
+// free list threaded through next and reused before the storage grows.
+class EdgePool {
+public:
+    static constexpr int NONE = -1;
+
+    int allocate(int destination, int weight);
+    void release(int handle);
+    void reserve(int count);
+    void clear();
+
+    Edge& operator[](int handle) { return edges_[handle]; }
+    const Edge& operator[](int handle) const { return edges_[handle]; }
+
+    int size() const;
+
+private:
+    std::vector<Edge> edges_;
+    int freeHead_ = NONE;
+    int freeCount_ = 0;
+};
+
+#endif // EDGE_POOL_HPP_INCLUDE
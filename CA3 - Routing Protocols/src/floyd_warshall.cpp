@@ -0,0 +1,151 @@
+#include "floyd_warshall.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "barrier.hpp"
+
+namespace floyd_warshall {
+
+namespace {
+
+constexpr int BS = DistanceMatrix::BLOCK_SIZE;
+
+// c[j] = min(c[j], a + b[j]) over one block row. The loaders and the CLI only
+// accept weights below INF_DISTANCE and cells only decrease, so no value
+// exceeds INF_DISTANCE and the sum of two of them cannot overflow.
+inline void minPlusRow(int* c, const int* b, int a) {
+#if defined(__AVX512F__)
+    const __m512i va = _mm512_set1_epi32(a);
+    for (int j = 0; j < BS; j += 16) {
+        __m512i sum = _mm512_add_epi32(va, _mm512_load_si512(b + j));
+        __m512i curr = _mm512_load_si512(c + j);
+        _mm512_store_si512(c + j, _mm512_min_epi32(curr, sum));
+    }
+#elif defined(__AVX2__)
+    const __m256i va = _mm256_set1_epi32(a);
+    for (int j = 0; j < BS; j += 8) {
+        __m256i sum = _mm256_add_epi32(va, _mm256_load_si256(reinterpret_cast<const __m256i*>(b + j)));
+        __m256i curr = _mm256_load_si256(reinterpret_cast<const __m256i*>(c + j));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(c + j), _mm256_min_epi32(curr, sum));
+    }
+#else
+    for (int j = 0; j < BS; ++j) {
+        c[j] = std::min(c[j], a + b[j]);
+    }
+#endif
+}
+
+class BlockedSolver {
+public:
+    BlockedSolver(DistanceMatrix& matrix, int threads)
+        : matrix_(matrix),
+          blocks_(matrix.stride() / BS),
+          threads_(threads),
+          barrier_(threads) {}
+
+    void solve() {
+        std::vector<std::thread> threads;
+        for (int t = 1; t < threads_; ++t) {
+            threads.emplace_back(&BlockedSolver::work, this, t);
+        }
+        work(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    DistanceMatrix& matrix_;
+    int blocks_;
+    int threads_;
+    Barrier barrier_;
+    std::atomic<int> nextRowColumnTile_{0};
+    std::atomic<int> nextTile_{0};
+
+    int* block(int bi, int bj) {
+        return matrix_.row(bi * BS) + bj * BS;
+    }
+
+    // Relaxes block c through the pivot blocks a (same rows) and b (same columns).
+    // The k loop is outermost, so c may alias a or b as in plain Floyd-Warshall.
+    void updateDependent(int* c, const int* a, const int* b) {
+        int stride = matrix_.stride();
+        for (int k = 0; k < BS; ++k) {
+            const int* bRow = b + k * stride;
+            for (int i = 0; i < BS; ++i) {
+                minPlusRow(c + i * stride, bRow, a[i * stride + k]);
+            }
+        }
+    }
+
+    // Same as above for blocks which alias neither pivot, with the row of c
+    // kept hot in cache while k varies.
+    void updateIndependent(int* c, const int* a, const int* b) {
+        int stride = matrix_.stride();
+        for (int i = 0; i < BS; ++i) {
+            int* cRow = c + i * stride;
+            const int* aRow = a + i * stride;
+            for (int k = 0; k < BS; ++k) {
+                minPlusRow(cRow, b + k * stride, aRow[k]);
+            }
+        }
+    }
+
+    void work(int tid) {
+        int others = blocks_ - 1;
+        for (int kb = 0; kb < blocks_; ++kb) {
+            int* pivot = block(kb, kb);
+            if (tid == 0) {
+                updateDependent(pivot, pivot, pivot);
+                nextRowColumnTile_.store(0, std::memory_order_relaxed);
+                nextTile_.store(0, std::memory_order_relaxed);
+            }
+            barrier_.wait();
+
+            for (int t = nextRowColumnTile_.fetch_add(1); t < 2 * others; t = nextRowColumnTile_.fetch_add(1)) {
+                int other = t % others;
+                other += (other >= kb);
+                if (t < others) {
+                    int* c = block(kb, other);
+                    updateDependent(c, pivot, c);
+                }
+                else {
+                    int* c = block(other, kb);
+                    updateDependent(c, c, pivot);
+                }
+            }
+            barrier_.wait();
+
+            for (int t = nextTile_.fetch_add(1); t < others * others; t = nextTile_.fetch_add(1)) {
+                int bi = t / others;
+                int bj = t % others;
+                bi += (bi >= kb);
+                bj += (bj >= kb);
+                updateIndependent(block(bi, bj), block(bi, kb), block(kb, bj));
+            }
+            barrier_.wait();
+        }
+    }
+};
+
+} // namespace
+
+void run(DistanceMatrix& matrix, int threads) {
+    if (matrix.size() == 0) {
+        return;
+    }
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    BlockedSolver solver(matrix, threads);
+    solver.solve();
+}
+
+} // namespace floyd_warshall
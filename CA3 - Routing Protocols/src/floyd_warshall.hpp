@@ -0,0 +1,14 @@
+#ifndef FLOYD_WARSHALL_HPP_INCLUDE
+#define FLOYD_WARSHALL_HPP_INCLUDE
+
+#include "distance_matrix.hpp"
+
+namespace floyd_warshall {
+
+// Turns an adjacency matrix into all-pairs shortest distances in place with the
+// three-phase blocked algorithm. threads = 0 uses every hardware thread.
+void run(DistanceMatrix& matrix, int threads = 0);
+
+} // namespace floyd_warshall
+
+#endif // FLOYD_WARSHALL_HPP_INCLUDE
@@ -0,0 +1,65 @@
+#include "forwarding_table.hpp"
+
+#include <algorithm>
+
+ForwardingTable::ForwardingTable(int source, std::vector<int> predecessor)
+    : source_(source),
+      predecessor_(std::move(predecessor)),
+      nextHop_(predecessor_.size(), -1) {
+    if (source_ < 0 || source_ >= size()) {
+        return;
+    }
+    nextHop_[source_] = source_;
+
+    // Walk up to the first node with a known next hop, then assign it to the
+    // whole walked chain, so every node is visited a constant number of times.
+    std::vector<int> chain;
+    for (int v = 0; v < size(); ++v) {
+        int curr = v;
+        while (nextHop_[curr] == -1 && predecessor_[curr] != -1) {
+            chain.push_back(curr);
+            curr = predecessor_[curr];
+        }
+        int hop = nextHop_[curr];
+        while (!chain.empty()) {
+            int node = chain.back();
+            chain.pop_back();
+            if (hop == source_) {
+                hop = node;
+            }
+            nextHop_[node] = hop;
+        }
+    }
+}
+
+int ForwardingTable::getSource() const {
+    return source_;
+}
+
+int ForwardingTable::size() const {
+    return predecessor_.size();
+}
+
+bool ForwardingTable::isReachable(int destination) const {
+    return nextHop_[destination] != -1;
+}
+
+int ForwardingTable::getNextHop(int destination) const {
+    return nextHop_[destination];
+}
+
+int ForwardingTable::getPredecessor(int destination) const {
+    return predecessor_[destination];
+}
+
+std::vector<int> ForwardingTable::getPath(int destination) const {
+    std::vector<int> path;
+    if (!isReachable(destination)) {
+        return path;
+    }
+    for (int curr = destination; curr != -1; curr = predecessor_[curr]) {
+        path.push_back(curr);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
@@ -0,0 +1,26 @@
+#ifndef FORWARDING_TABLE_HPP_INCLUDE
+#define FORWARDING_TABLE_HPP_INCLUDE
+
+#include <vector>
+
+// Result of a single-source run over node ids: the predecessor of every node on
+// its shortest path and the first hop from the source. Paths are rebuilt on demand.
+class ForwardingTable {
+public:
+    ForwardingTable() = default;
+    ForwardingTable(int source, std::vector<int> predecessor);
+
+    int getSource() const;
+    int size() const;
+    bool isReachable(int destination) const;
+    int getNextHop(int destination) const;
+    int getPredecessor(int destination) const;
+    std::vector<int> getPath(int destination) const;
+
+private:
+    int source_ = -1;
+    std::vector<int> predecessor_;
+    std::vector<int> nextHop_;
+};
+
+#endif // FORWARDING_TABLE_HPP_INCLUDE
@@ -0,0 +1,452 @@
+#include "link_state.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#include "barrier.hpp"
+
+namespace link_state {
+
+namespace {
+
+constexpr int NEVER = std::numeric_limits<int>::max();
+
+// OSPF router-LSA: 20 byte header, 4 bytes of flags and counts, 12 bytes per link.
+constexpr int LSA_HEADER_BYTES = 24;
+constexpr int LINK_BYTES = 12;
+
+struct Link {
+    int neighbor;
+    int weight;
+
+    bool operator<(const Link& other) const { return neighbor < other.neighbor; }
+    bool operator==(const Link& other) const { return neighbor == other.neighbor && weight == other.weight; }
+};
+
+// LSA instances are immutable once originated and shared by every LSDB and message
+// holding them, and freed when the last one lets go. Age grows by one per hop and
+// per tick spent in a database, so it is now - originatedAt.
+struct Lsa {
+    int origin;
+    int seq;
+    int originatedAt;
+    std::vector<Link> links; // sorted by neighbor
+
+    bool hasLink(int neighbor) const {
+        return std::binary_search(links.begin(), links.end(), Link{neighbor, 0});
+    }
+};
+
+using LsaPtr = std::shared_ptr<const Lsa>;
+
+struct Message {
+    int to;
+    int from;
+    LsaPtr lsa;
+};
+
+struct Router {
+    std::vector<Link> links;
+    int seq = 0; // of the last LSA originated
+    std::vector<LsaPtr> lsdb;
+    std::vector<Message> inbox;
+
+    int nextRefresh = NEVER;
+    int nextSpf = NEVER;
+    int lastSpf = NEVER;
+    int hold = 0;
+    uint64_t tableHash = 0;
+    RouterReport report;
+};
+
+struct alignas(64) Worker {
+    int begin = 0;
+    int end = 0;
+    int now = 0;
+    size_t eventCursor = 0;
+
+    std::vector<std::vector<Message>> outbox; // one per destination worker
+    std::vector<int> changed;
+    std::vector<std::pair<int, int>> newAdjacencies;
+
+    std::vector<int> distance;
+    std::vector<int> parent;
+    MinHeap heap;
+
+    int originated = 0;
+    long long transmissions = 0;
+    long long bytes = 0;
+    long long duplicates = 0;
+    long long spfRuns = 0;
+    RoutingStats stats;
+
+    // Written between the two barriers of a tick and read by every worker after the second.
+    long long inFlight = 0;
+    int nextTimer = NEVER;
+    int nextRefresh = NEVER;
+};
+
+class Simulator {
+public:
+    Simulator(const CsrGraph& csr, const Options& options, int threads)
+        : options_(options),
+          nodeCount_(csr.nodeCount()),
+          chunk_((csr.nodeCount() + threads - 1) / threads),
+          routers_(csr.nodeCount()),
+          workers_(threads),
+          barrier_(threads),
+          refreshInterval_(std::max(1, options.maxAge / 2)),
+          events_(options.events) {
+        std::stable_sort(events_.begin(), events_.end(), [](const LinkEvent& a, const LinkEvent& b) {
+            return a.time < b.time;
+        });
+        for (int r = 0; r < nodeCount_; ++r) {
+            Router& router = routers_[r];
+            for (int e = csr.offsets[r]; e < csr.offsets[r + 1]; ++e) {
+                router.links.push_back({csr.targets[e], csr.weights[e]});
+            }
+            std::sort(router.links.begin(), router.links.end());
+            router.lsdb.assign(nodeCount_, nullptr);
+            router.hold = options_.spfHold;
+        }
+        for (int t = 0; t < threads; ++t) {
+            Worker& worker = workers_[t];
+            worker.begin = std::min(nodeCount_, t * chunk_);
+            worker.end = std::min(nodeCount_, worker.begin + chunk_);
+            worker.outbox.resize(threads);
+            worker.distance.resize(nodeCount_);
+            worker.parent.resize(nodeCount_);
+        }
+    }
+
+    Report simulate(int observed) {
+        std::vector<std::thread> threads;
+        for (int t = 1; t < static_cast<int>(workers_.size()); ++t) {
+            threads.emplace_back(&Simulator::work, this, t);
+        }
+        work(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        Report report;
+        report.routers.reserve(nodeCount_);
+        for (auto& router : routers_) {
+            report.routers.push_back(router.report);
+        }
+        for (auto& worker : workers_) {
+            report.originated += worker.originated;
+            report.transmissions += worker.transmissions;
+            report.bytes += worker.bytes;
+            report.duplicates += worker.duplicates;
+            report.spfRuns += worker.spfRuns;
+            report.stats.relaxations += worker.stats.relaxations;
+            report.stats.heapOperations += worker.stats.heapOperations;
+        }
+        report.finishedAt = workers_[0].now;
+
+        if (observed >= 0) {
+            Worker& worker = workers_[0];
+            shortestPaths(observed, worker);
+            report.distance = worker.distance;
+            report.parent = worker.parent;
+        }
+        return report;
+    }
+
+private:
+    const Options& options_;
+    int nodeCount_;
+    int chunk_;
+    std::vector<Router> routers_;
+    std::vector<Worker> workers_;
+    Barrier barrier_;
+    int refreshInterval_;
+    std::vector<LinkEvent> events_;
+
+    int ownerOf(int router) const { return router / chunk_; }
+
+    bool isExpired(const Lsa* lsa, int now) const { return now - lsa->originatedAt >= options_.maxAge; }
+
+    // An instance that only refreshes the stored one does not need a new SPF run.
+    bool changes(const Lsa* lsa, const Lsa* current, int now) const {
+        return current == nullptr || isExpired(current, now) || lsa->links != current->links;
+    }
+
+    void work(int id) {
+        Worker& worker = workers_[id];
+        for (int r = worker.begin; r < worker.end; ++r) {
+            originate(r, worker);
+        }
+        while (true) {
+            step(worker);
+            barrier_.wait();
+            deliver(id, worker);
+            barrier_.wait();
+
+            int next = NEVER;
+            for (auto& other : workers_) {
+                if (other.inFlight != 0) {
+                    next = worker.now + 1;
+                    break;
+                }
+                next = std::min(next, other.nextTimer);
+            }
+            // Refreshes keep the LSDBs from aging out until the last event, but do not
+            // keep the simulation going on their own.
+            if (worker.eventCursor < events_.size()) {
+                next = std::min(next, std::max(worker.now + 1, events_[worker.eventCursor].time));
+                for (auto& other : workers_) {
+                    next = std::min(next, other.nextRefresh);
+                }
+            }
+            if (next == NEVER) {
+                break;
+            }
+            worker.now = std::max(worker.now + 1, next);
+        }
+    }
+
+    void step(Worker& worker) {
+        applyEvents(worker);
+        for (int r = worker.begin; r < worker.end; ++r) {
+            Router& router = routers_[r];
+            std::sort(router.inbox.begin(), router.inbox.end(), [](const Message& a, const Message& b) {
+                return std::make_tuple(a.lsa->origin, -a.lsa->seq, a.from) < std::make_tuple(b.lsa->origin, -b.lsa->seq, b.from);
+            });
+            for (const Message& message : router.inbox) {
+                receive(r, message, worker);
+            }
+            router.inbox.clear();
+            if (router.nextRefresh <= worker.now) {
+                originate(r, worker);
+            }
+            if (router.nextSpf <= worker.now) {
+                runSpf(r, worker);
+            }
+        }
+    }
+
+    void deliver(int id, Worker& worker) {
+        worker.inFlight = 0;
+        for (auto& other : workers_) {
+            for (Message& message : other.outbox[id]) {
+                routers_[message.to].inbox.push_back(std::move(message));
+            }
+            worker.inFlight += other.outbox[id].size();
+            other.outbox[id].clear();
+        }
+        worker.nextTimer = NEVER;
+        worker.nextRefresh = NEVER;
+        for (int r = worker.begin; r < worker.end; ++r) {
+            worker.nextTimer = std::min(worker.nextTimer, routers_[r].nextSpf);
+            worker.nextRefresh = std::min(worker.nextRefresh, routers_[r].nextRefresh);
+        }
+    }
+
+    // Routers on both ends of a changed link re-originate their LSA once per tick.
+    // A new adjacency is synchronized by sending the whole LSDB over it.
+    void applyEvents(Worker& worker) {
+        worker.changed.clear();
+        worker.newAdjacencies.clear();
+        for (; worker.eventCursor < events_.size() && events_[worker.eventCursor].time <= worker.now; ++worker.eventCursor) {
+            const LinkEvent& event = events_[worker.eventCursor];
+            setLink(event.source, event.destination, event.weight, worker);
+            setLink(event.destination, event.source, event.weight, worker);
+        }
+        std::sort(worker.changed.begin(), worker.changed.end());
+        worker.changed.erase(std::unique(worker.changed.begin(), worker.changed.end()), worker.changed.end());
+        for (int r : worker.changed) {
+            originate(r, worker);
+        }
+        for (auto& [r, neighbor] : worker.newAdjacencies) {
+            for (const LsaPtr& lsa : routers_[r].lsdb) {
+                if (lsa != nullptr && !isExpired(lsa.get(), worker.now)) {
+                    send(r, neighbor, lsa, worker);
+                }
+            }
+        }
+    }
+
+    void setLink(int r, int neighbor, int weight, Worker& worker) {
+        if (r < worker.begin || r >= worker.end) {
+            return;
+        }
+        auto& links = routers_[r].links;
+        auto it = std::lower_bound(links.begin(), links.end(), Link{neighbor, 0});
+        bool exists = it != links.end() && it->neighbor == neighbor;
+        if (weight == 0) {
+            if (!exists) {
+                return;
+            }
+            links.erase(it);
+        }
+        else if (exists) {
+            if (it->weight == weight) {
+                return;
+            }
+            it->weight = weight;
+        }
+        else {
+            links.insert(it, {neighbor, weight});
+            worker.newAdjacencies.emplace_back(r, neighbor);
+        }
+        worker.changed.push_back(r);
+    }
+
+    // Routers also re-originate their LSA every maxAge / 2 ticks, like the
+    // LSRefreshTime of OSPF, so that it does not age out of the other LSDBs.
+    void originate(int r, Worker& worker) {
+        Router& router = routers_[r];
+        LsaPtr lsa = std::make_shared<const Lsa>(Lsa{r, ++router.seq, worker.now, router.links});
+        bool changed = changes(lsa.get(), router.lsdb[r].get(), worker.now);
+        router.lsdb[r] = lsa;
+        router.nextRefresh = worker.now + refreshInterval_;
+        ++worker.originated;
+        flood(r, lsa, -1, worker);
+        if (changed) {
+            scheduleSpf(router, worker.now);
+        }
+    }
+
+    void receive(int r, const Message& message, Worker& worker) {
+        Router& router = routers_[r];
+        const LsaPtr& lsa = message.lsa;
+        ++router.report.lsasReceived;
+        if (isExpired(lsa.get(), worker.now)) {
+            return;
+        }
+
+        LsaPtr& current = router.lsdb[lsa->origin];
+        if (current == nullptr || lsa->seq > current->seq) {
+            bool changed = changes(lsa.get(), current.get(), worker.now);
+            current = lsa;
+            flood(r, lsa, message.from, worker);
+            if (changed) {
+                scheduleSpf(router, worker.now);
+            }
+        }
+        else if (lsa->seq == current->seq) {
+            ++router.report.duplicates;
+            ++worker.duplicates;
+        }
+        else {
+            // The neighbor is behind, answer with the newer instance.
+            send(r, message.from, current, worker);
+        }
+    }
+
+    void flood(int r, const LsaPtr& lsa, int except, Worker& worker) {
+        for (const Link& link : routers_[r].links) {
+            if (link.neighbor != except) {
+                send(r, link.neighbor, lsa, worker);
+            }
+        }
+    }
+
+    void send(int from, int to, const LsaPtr& lsa, Worker& worker) {
+        worker.outbox[ownerOf(to)].push_back({to, from, lsa});
+        ++routers_[from].report.lsasSent;
+        ++worker.transmissions;
+        worker.bytes += LSA_HEADER_BYTES + LINK_BYTES * static_cast<long long>(lsa->links.size());
+    }
+
+    void scheduleSpf(Router& router, int now) {
+        if (router.nextSpf != NEVER) {
+            return;
+        }
+        router.nextSpf = now + options_.spfDelay;
+        if (router.lastSpf != NEVER) {
+            router.nextSpf = std::max(router.nextSpf, router.lastSpf + router.hold);
+        }
+    }
+
+    void runSpf(int r, Worker& worker) {
+        Router& router = routers_[r];
+        int now = worker.now;
+        if (router.lastSpf != NEVER && now - router.lastSpf <= options_.spfMaxHold) {
+            router.hold = std::min(router.hold * 2, options_.spfMaxHold);
+        }
+        else {
+            router.hold = options_.spfHold;
+        }
+        router.lastSpf = now;
+        router.nextSpf = NEVER;
+        ++router.report.spfRuns;
+        ++worker.spfRuns;
+
+        shortestPaths(r, worker);
+        uint64_t hash = 1469598103934665603ULL;
+        for (int i = 0; i < nodeCount_; ++i) {
+            uint64_t entry = (static_cast<uint64_t>(worker.distance[i]) << 32) | static_cast<uint32_t>(worker.parent[i]);
+            hash = (hash ^ entry) * 1099511628211ULL;
+        }
+        if (hash != router.tableHash) {
+            router.tableHash = hash;
+            router.report.convergedAt = now;
+        }
+    }
+
+    // Dijkstra over the LSDB of r. A link is only used if the LSA of its far end
+    // lists it back (the OSPF two-way check), so half-withdrawn links are ignored.
+    void shortestPaths(int r, Worker& worker) {
+        const auto& lsdb = routers_[r].lsdb;
+        auto& distance = worker.distance;
+        auto& parent = worker.parent;
+        std::fill(distance.begin(), distance.end(), INF_DISTANCE);
+        std::fill(parent.begin(), parent.end(), -1);
+
+        distance[r] = 0;
+        worker.heap.push({r, 0});
+        ++worker.stats.heapOperations;
+        while (!worker.heap.empty()) {
+            NodeDistance top = worker.heap.top();
+            worker.heap.pop();
+            ++worker.stats.heapOperations;
+            if (top.distance > distance[top.node]) {
+                continue;
+            }
+            const Lsa* lsa = lsdb[top.node].get();
+            if (lsa == nullptr || isExpired(lsa, worker.now)) {
+                continue;
+            }
+            for (const Link& link : lsa->links) {
+                const Lsa* back = lsdb[link.neighbor].get();
+                if (back == nullptr || isExpired(back, worker.now) || !back->hasLink(top.node)) {
+                    continue;
+                }
+                ++worker.stats.relaxations;
+                int candidate = top.distance + link.weight;
+                if (candidate < distance[link.neighbor]) {
+                    distance[link.neighbor] = candidate;
+                    parent[link.neighbor] = top.node;
+                    worker.heap.push({link.neighbor, candidate});
+                    ++worker.stats.heapOperations;
+                }
+            }
+        }
+    }
+};
+
+} // namespace
+
+Report run(const CsrGraph& csr, const Options& options, int observed) {
+    if (csr.nodeCount() == 0) {
+        return Report();
+    }
+    int threads = options.threads;
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, csr.nodeCount());
+
+    Simulator simulator(csr, options, threads);
+    return simulator.simulate(observed);
+}
+
+} // namespace link_state
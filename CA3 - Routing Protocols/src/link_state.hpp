@@ -0,0 +1,62 @@
+#ifndef LINK_STATE_HPP_INCLUDE
+#define LINK_STATE_HPP_INCLUDE
+
+#include <vector>
+
+#include "csr_graph.hpp"
+#include "shortest_path.hpp"
+
+namespace link_state {
+
+// Changes the link between source and destination at the given tick.
+// A weight of 0 takes the link down, a positive weight sets or adds it.
+struct LinkEvent {
+    int time;
+    int source;
+    int destination;
+    int weight;
+};
+
+// Times are in ticks, one tick being the delay of a single flooding hop.
+struct Options {
+    int threads = 0;       // 0 uses every hardware thread
+    int spfDelay = 5;      // wait between the first LSDB change and SPF
+    int spfHold = 10;      // initial minimum gap between two SPF runs
+    int spfMaxHold = 100;  // the gap doubles up to this while changes keep coming
+    int maxAge = 3600;     // LSAs at least this old are neither flooded nor used, refreshed every maxAge / 2
+    std::vector<LinkEvent> events;
+};
+
+struct RouterReport {
+    int lsasSent = 0;
+    int lsasReceived = 0;
+    int duplicates = 0;
+    int spfRuns = 0;
+    int convergedAt = -1; // tick of the last SPF run that changed the routing table
+};
+
+struct Report {
+    std::vector<RouterReport> routers;
+    int originated = 0;
+    long long transmissions = 0;
+    long long bytes = 0;
+    long long duplicates = 0;
+    long long spfRuns = 0;
+    int finishedAt = 0;
+    RoutingStats stats;
+
+    // Routing table of the observed router, computed from its own LSDB.
+    std::vector<int> distance;
+    std::vector<int> parent;
+};
+
+// Simulates OSPF-like flooding from a cold start: every router originates its
+// router-LSA at tick 0, LSAs flood hop by hop with sequence numbers and age,
+// and each router runs throttled SPF over its own LSDB. Routers are partitioned
+// across threads and the result does not depend on the thread count.
+// The simulation ends once no LSA is in flight and no SPF or event is pending.
+Report run(const CsrGraph& csr, const Options& options, int observed = -1);
+
+} // namespace link_state
+
+#endif // LINK_STATE_HPP_INCLUDE
@@ -1,9 +1,58 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
 #include "command_line_interface.hpp"
 #include "network.hpp"
+#include "output_writer.hpp"
+
+int main(int argc, char* argv[]) {
+    static const std::string usage = "Usage: main.out [<script>] [--quiet] [--format=table|csv|binary]";
+    std::string script;
+    bool quiet = false;
+    OutputWriter::Format format = OutputWriter::Format::table;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quiet") {
+            quiet = true;
+        }
+        else if (arg == "--format=table") {
+            format = OutputWriter::Format::table;
+        }
+        else if (arg == "--format=csv") {
+            format = OutputWriter::Format::csv;
+        }
+        else if (arg == "--format=binary") {
+            format = OutputWriter::Format::binary;
+        }
+        else if (arg.rfind("--", 0) != 0 && script.empty()) {
+            script = arg;
+        }
+        else {
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+    }
+
+    // A script of "-" reads the commands from the standard input without the prompt.
+    bool interactive = script.empty();
+    std::ifstream file;
+    std::istream* input = &std::cin;
+    if (!interactive && script != "-") {
+        file.open(script);
+        if (!file) {
+            std::cerr << "Cannot open " << script << std::endl;
+            return 1;
+        }
+        input = &file;
+    }
+    if (!interactive) {
+        std::ios::sync_with_stdio(false);
+    }
 
-int main() {
     Network network;
-    CommandLineInterface cli(network);
-    cli.run();
+    OutputWriter out(std::cout, format, quiet);
+    CommandLineInterface cli(network, out);
+    cli.run(*input, interactive);
     return 0;
 }
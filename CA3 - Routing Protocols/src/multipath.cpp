@@ -0,0 +1,252 @@
+#include "multipath.hpp"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+namespace multipath {
+
+namespace {
+
+// Dijkstra buffers which are reset lazily, so repeated spur searches of
+// Yen's algorithm do not pay O(V) for every query.
+class PathSearch {
+public:
+    PathSearch(const CsrGraph& csr, RoutingStats& stats)
+        : csr_(csr),
+          stats_(stats),
+          distance_(csr.nodeCount(), INF_DISTANCE),
+          parent_(csr.nodeCount(), -1),
+          blockedNodes_(csr.nodeCount(), false),
+          blockedEdges_(csr.edgeCount(), false) {}
+
+    void blockNode(int node) {
+        blockedNodes_[node] = true;
+        blockedNodeList_.push_back(node);
+    }
+
+    void blockEdge(int source, int destination) {
+        for (int e = csr_.offsets[source]; e < csr_.offsets[source + 1]; ++e) {
+            if (csr_.targets[e] == destination) {
+                blockedEdges_[e] = true;
+                blockedEdgeList_.push_back(e);
+            }
+        }
+    }
+
+    void unblockAll() {
+        for (int node : blockedNodeList_) blockedNodes_[node] = false;
+        for (int e : blockedEdgeList_) blockedEdges_[e] = false;
+        blockedNodeList_.clear();
+        blockedEdgeList_.clear();
+    }
+
+    bool find(int src, int dst, WeightedPath& path) {
+        for (int node : touched_) {
+            distance_[node] = INF_DISTANCE;
+            parent_[node] = -1;
+        }
+        touched_.clear();
+
+        distance_[src] = 0;
+        touched_.push_back(src);
+        MinHeap pq;
+        pq.push({src, 0});
+        ++stats_.heapOperations;
+        while (!pq.empty()) {
+            auto top = pq.top();
+            pq.pop();
+            ++stats_.heapOperations;
+            if (top.distance > distance_[top.node]) {
+                continue;
+            }
+            if (top.node == dst) {
+                break;
+            }
+            for (int e = csr_.offsets[top.node]; e < csr_.offsets[top.node + 1]; ++e) {
+                ++stats_.relaxations;
+                int dest = csr_.targets[e];
+                if (blockedEdges_[e] || blockedNodes_[dest]) {
+                    continue;
+                }
+                int newDist = top.distance + csr_.weights[e];
+                if (newDist < distance_[dest]) {
+                    if (distance_[dest] == INF_DISTANCE) {
+                        touched_.push_back(dest);
+                    }
+                    distance_[dest] = newDist;
+                    parent_[dest] = top.node;
+                    pq.push({dest, newDist});
+                    ++stats_.heapOperations;
+                }
+            }
+        }
+
+        if (distance_[dst] == INF_DISTANCE) {
+            return false;
+        }
+        path.cost = distance_[dst];
+        path.nodes.clear();
+        for (int curr = dst; curr != -1; curr = parent_[curr]) {
+            path.nodes.push_back(curr);
+        }
+        std::reverse(path.nodes.begin(), path.nodes.end());
+        return true;
+    }
+
+private:
+    const CsrGraph& csr_;
+    RoutingStats& stats_;
+    std::vector<int> distance_;
+    std::vector<int> parent_;
+    std::vector<int> touched_;
+    std::vector<char> blockedNodes_;
+    std::vector<char> blockedEdges_;
+    std::vector<int> blockedNodeList_;
+    std::vector<int> blockedEdgeList_;
+};
+
+int edgeWeight(const CsrGraph& csr, int source, int destination) {
+    int weight = INF_DISTANCE;
+    for (int e = csr.offsets[source]; e < csr.offsets[source + 1]; ++e) {
+        if (csr.targets[e] == destination) {
+            weight = std::min(weight, csr.weights[e]);
+        }
+    }
+    return weight;
+}
+
+} // namespace
+
+EcmpTable getEcmpTable(const CsrGraph& csr, int src, RoutingStats& stats) {
+    int n = csr.nodeCount();
+    EcmpTable table;
+    table.source = src;
+    table.distance.assign(n, INF_DISTANCE);
+
+    std::vector<int> order;
+    order.reserve(n);
+    table.distance[src] = 0;
+    MinHeap pq;
+    pq.push({src, 0});
+    ++stats.heapOperations;
+    while (!pq.empty()) {
+        auto top = pq.top();
+        pq.pop();
+        ++stats.heapOperations;
+        if (top.distance > table.distance[top.node]) {
+            continue;
+        }
+        order.push_back(top.node);
+        for (int e = csr.offsets[top.node]; e < csr.offsets[top.node + 1]; ++e) {
+            ++stats.relaxations;
+            int dest = csr.targets[e];
+            int newDist = top.distance + csr.weights[e];
+            if (newDist < table.distance[dest]) {
+                table.distance[dest] = newDist;
+                pq.push({dest, newDist});
+                ++stats.heapOperations;
+            }
+        }
+    }
+
+    // Number of shortest paths to every node per first hop, built over the
+    // shortest path DAG in settling order. Links are stored in both
+    // directions, so the edges of v are also its incoming edges.
+    std::vector<std::vector<std::pair<int, double>>> pathCounts(n);
+    for (int v : order) {
+        if (v == src) {
+            continue;
+        }
+        auto& counts = pathCounts[v];
+        auto add = [&counts](int hop, double count) {
+            for (auto& entry : counts) {
+                if (entry.first == hop) {
+                    entry.second += count;
+                    return;
+                }
+            }
+            counts.push_back({hop, count});
+        };
+        for (int e = csr.offsets[v]; e < csr.offsets[v + 1]; ++e) {
+            int u = csr.targets[e];
+            if (table.distance[u] == INF_DISTANCE || table.distance[u] + csr.weights[e] != table.distance[v]) {
+                continue;
+            }
+            if (u == src) {
+                add(v, 1);
+                continue;
+            }
+            for (auto& entry : pathCounts[u]) {
+                add(entry.first, entry.second);
+            }
+        }
+    }
+
+    table.offsets.assign(n + 1, 0);
+    for (int v = 0; v < n; ++v) {
+        auto& counts = pathCounts[v];
+        std::sort(counts.begin(), counts.end());
+        double total = 0;
+        for (auto& entry : counts) {
+            total += entry.second;
+        }
+        for (auto& entry : counts) {
+            table.nextHops.push_back(entry.first);
+            table.shares.push_back(entry.second / total);
+        }
+        table.offsets[v + 1] = table.nextHops.size();
+    }
+    std::replace(table.distance.begin(), table.distance.end(), INF_DISTANCE, -1);
+    return table;
+}
+
+std::vector<WeightedPath> getKShortestPaths(const CsrGraph& csr, int src, int dst, int k, RoutingStats& stats) {
+    std::vector<WeightedPath> paths;
+    PathSearch search(csr, stats);
+    WeightedPath path;
+    if (k <= 0 || !search.find(src, dst, path)) {
+        return paths;
+    }
+    paths.push_back(path);
+
+    std::set<std::pair<int, std::vector<int>>> candidates;
+    std::set<std::vector<int>> found = {path.nodes};
+    while (static_cast<int>(paths.size()) < k) {
+        const std::vector<int> prev = paths.back().nodes;
+        int rootCost = 0;
+        for (unsigned i = 0; i + 1 < prev.size(); ++i) {
+            int spur = prev[i];
+            for (auto& accepted : paths) {
+                if (accepted.nodes.size() > i + 1 && std::equal(prev.begin(), prev.begin() + i + 1, accepted.nodes.begin())) {
+                    search.blockEdge(spur, accepted.nodes[i + 1]);
+                }
+            }
+            for (unsigned j = 0; j < i; ++j) {
+                search.blockNode(prev[j]);
+            }
+
+            WeightedPath spurPath;
+            if (search.find(spur, dst, spurPath)) {
+                std::vector<int> nodes(prev.begin(), prev.begin() + i);
+                nodes.insert(nodes.end(), spurPath.nodes.begin(), spurPath.nodes.end());
+                if (found.find(nodes) == found.end()) {
+                    candidates.insert({rootCost + spurPath.cost, std::move(nodes)});
+                }
+            }
+            search.unblockAll();
+            rootCost += edgeWeight(csr, prev[i], prev[i + 1]);
+        }
+
+        if (candidates.empty()) {
+            break;
+        }
+        auto best = candidates.begin();
+        paths.push_back({best->first, best->second});
+        found.insert(best->second);
+        candidates.erase(best);
+    }
+    return paths;
+}
+
+} // namespace multipath
@@ -0,0 +1,34 @@
+#ifndef MULTIPATH_HPP_INCLUDE
+#define MULTIPATH_HPP_INCLUDE
+
+#include <vector>
+
+#include "csr_graph.hpp"
+#include "shortest_path.hpp"
+
+// Equal-cost next hops of every destination from one source.
+// Next hops of d are nextHops[offsets[d]] .. nextHops[offsets[d + 1] - 1] and shares
+// holds the fraction of the equal-cost paths to d which leave through each of them.
+struct EcmpTable {
+    int source = -1;
+    std::vector<int> distance;
+    std::vector<int> offsets;
+    std::vector<int> nextHops;
+    std::vector<double> shares;
+};
+
+struct WeightedPath {
+    int cost;
+    std::vector<int> nodes;
+};
+
+namespace multipath {
+
+EcmpTable getEcmpTable(const CsrGraph& csr, int src, RoutingStats& stats);
+
+// Yen's algorithm, returns at most k loopless paths in increasing order of cost.
+std::vector<WeightedPath> getKShortestPaths(const CsrGraph& csr, int src, int dst, int k, RoutingStats& stats);
+
+} // namespace multipath
+
+#endif // MULTIPATH_HPP_INCLUDE
@@ -1,13 +1,14 @@
 #include "network.hpp"
 
+#include "floyd_warshall.hpp"
+
 #include <algorithm>
 #include <queue>
+#include <stdexcept>
 
-Network::~Network() {
-    for (auto& node : nodes_) {
-        delete node;
-    }
-}
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 Node* Network::operator[](const std::string& name) const {
     auto it = nodeMap_.find(name);
@@ -32,37 +33,142 @@ bool Network::addNode(const std::string& name) {
     if (doesNodeExist(name)) {
         return false;
     }
-    nodes_.push_back(new Node(name));
+    nodes_.push_back(&nodeSlab_[nodeSlab_.emplace(name)]);
+    firstEdge_.push_back(EdgePool::NONE);
+    lastEdge_.push_back(EdgePool::NONE);
     nodeMap_[name] = nodes_.size() - 1;
+    csrDirty_ = true;
+    hierarchyDirty_ = true;
     return true;
 }
 
 bool Network::addEdge(const std::string& source, const std::string& destination, int weight) {
-    Node* src = (*this)[source];
-    Node* dest = (*this)[destination];
-    if (src == nullptr || dest == nullptr) {
+    int src = getNodeIndex(source);
+    int dest = getNodeIndex(destination);
+    if (src == -1 || dest == -1) {
+        return false;
+    }
+    csrDirty_ = true;
+    hierarchyDirty_ = true;
+    int previous;
+    if (findEdge(src, dest, previous) != EdgePool::NONE) {
+        return false;
+    }
+    linkEdge(src, dest, weight);
+    if (findEdge(dest, src, previous) != EdgePool::NONE) {
         return false;
     }
-    return src->addEdge(dest, weight) && dest->addEdge(src, weight);
+    linkEdge(dest, src, weight);
+    return true;
 }
 
 bool Network::removeEdge(const std::string& source, const std::string& destination) {
-    Node* src = (*this)[source];
-    Node* dest = (*this)[destination];
-    if (src == nullptr || dest == nullptr) {
+    int src = getNodeIndex(source);
+    int dest = getNodeIndex(destination);
+    if (src == -1 || dest == -1) {
+        return false;
+    }
+    csrDirty_ = true;
+    hierarchyDirty_ = true;
+    int previous;
+    int edge = findEdge(src, dest, previous);
+    if (edge == EdgePool::NONE) {
         return false;
     }
-    return src->removeEdge(dest) && dest->removeEdge(src);
+    unlinkEdge(src, edge, previous);
+    edge = findEdge(dest, src, previous);
+    if (edge == EdgePool::NONE) {
+        return false;
+    }
+    unlinkEdge(dest, edge, previous);
+    return true;
 }
 
 void Network::modifyEdge(const std::string& source, const std::string& destination, int weight) {
-    Node* src = (*this)[source];
-    Node* dest = (*this)[destination];
-    if (src == nullptr || dest == nullptr) {
+    int src = getNodeIndex(source);
+    int dest = getNodeIndex(destination);
+    if (src == -1 || dest == -1) {
         return;
     }
-    src->modifyEdge(dest, weight);
-    dest->modifyEdge(src, weight);
+    csrDirty_ = true;
+    hierarchyDirty_ = true;
+    for (auto [from, to] : {std::make_pair(src, dest), std::make_pair(dest, src)}) {
+        int previous;
+        int edge = findEdge(from, to, previous);
+        if (edge == EdgePool::NONE) {
+            linkEdge(from, to, weight);
+        }
+        else {
+            edges_[edge].weight = weight;
+        }
+    }
+}
+
+// Drops the old topology in bulk: one free per node block and one for all edges.
+void Network::loadGraph(std::vector<std::string> names, CsrGraph csr) {
+    nodes_.clear();
+    nodeMap_.clear();
+    nodeSlab_.clear();
+    edges_.clear();
+    forwardingTable_ = ForwardingTable();
+
+    int nodeCount = names.size();
+    nodes_.reserve(nodeCount);
+    nodeMap_.reserve(nodeCount);
+    for (auto& name : names) {
+        nodeMap_[name] = nodes_.size();
+        nodes_.push_back(&nodeSlab_[nodeSlab_.emplace(std::move(name))]);
+    }
+
+    // Edges of a node are allocated consecutively and linked in CSR order.
+    edges_.reserve(csr.edgeCount());
+    firstEdge_.assign(nodeCount, EdgePool::NONE);
+    lastEdge_.assign(nodeCount, EdgePool::NONE);
+    for (int i = 0; i < nodeCount; ++i) {
+        for (int e = csr.offsets[i]; e < csr.offsets[i + 1]; ++e) {
+            linkEdge(i, csr.targets[e], csr.weights[e]);
+        }
+    }
+
+    csr_ = std::move(csr);
+    csrDirty_ = false;
+    hierarchyDirty_ = true;
+}
+
+int Network::findEdge(int source, int destination, int& previous) const {
+    previous = EdgePool::NONE;
+    for (int e = firstEdge_[source]; e != EdgePool::NONE; e = edges_[e].next) {
+        if (edges_[e].destination == destination) {
+            return e;
+        }
+        previous = e;
+    }
+    return EdgePool::NONE;
+}
+
+void Network::linkEdge(int source, int destination, int weight) {
+    int edge = edges_.allocate(destination, weight);
+    if (lastEdge_[source] == EdgePool::NONE) {
+        firstEdge_[source] = edge;
+    }
+    else {
+        edges_[lastEdge_[source]].next = edge;
+    }
+    lastEdge_[source] = edge;
+}
+
+void Network::unlinkEdge(int source, int edge, int previous) {
+    int next = edges_[edge].next;
+    if (previous == EdgePool::NONE) {
+        firstEdge_[source] = next;
+    }
+    else {
+        edges_[previous].next = next;
+    }
+    if (lastEdge_[source] == edge) {
+        lastEdge_[source] = previous;
+    }
+    edges_.release(edge);
 }
 
 const std::vector<Node*>& Network::getNodes() const {
@@ -77,69 +183,82 @@ int Network::getNodeIndex(const std::string& name) const {
     return it->second;
 }
 
-std::vector<std::vector<int>> Network::getAdjacencyMatrix() const {
-    std::vector<std::vector<int>> matrix(nodes_.size(), std::vector<int>(nodes_.size(), -1));
+DistanceMatrix Network::getAdjacencyMatrix() {
+    getCsrGraph();
+    DistanceMatrix matrix(nodes_.size());
     for (unsigned i = 0; i < nodes_.size(); ++i) {
-        matrix[i][i] = 0;
-        for (auto& edge : nodes_[i]->getEdges()) {
-            int dest = nodeMap_.find(edge->destination->getName())->second;
-            matrix[i][dest] = edge->weight;
+        int* row = matrix.row(i);
+        row[i] = 0;
+        for (int e = csr_.offsets[i]; e < csr_.offsets[i + 1]; ++e) {
+            row[csr_.targets[e]] = csr_.weights[e];
         }
     }
     return matrix;
 }
 
-struct NodeDistance {
-    Node* destination;
-    int distance;
-
-    bool operator<(const NodeDistance& other) const {
-        return distance < other.distance;
+const CsrGraph& Network::getCsrGraph() {
+    if (!csrDirty_) {
+        return csr_;
     }
-    bool operator>(const NodeDistance& other) const {
-        return distance > other.distance;
+
+    csr_.offsets.assign(nodes_.size() + 1, 0);
+    csr_.targets.clear();
+    csr_.weights.clear();
+    csr_.targets.reserve(edges_.size());
+    csr_.weights.reserve(edges_.size());
+    for (unsigned i = 0; i < nodes_.size(); ++i) {
+        for (int e = firstEdge_[i]; e != EdgePool::NONE; e = edges_[e].next) {
+            csr_.targets.push_back(edges_[e].destination);
+            csr_.weights.push_back(edges_[e].weight);
+        }
+        csr_.offsets[i + 1] = csr_.targets.size();
     }
-};
+    csrDirty_ = false;
+    return csr_;
+}
 
 std::vector<std::vector<int>> Network::getLsrpTable(Node* src) {
+    getCsrGraph();
+    int source = nodeMap_.at(src->getName());
     std::vector<std::vector<int>> iterTable;
-    std::unordered_map<Node*, int> distance;
-    std::unordered_map<Node*, Node*> parent;
-    for (auto& node : nodes_) {
-        distance[node] = -1;
-        parent[node] = nullptr;
-    }
+    std::vector<int> distance(nodes_.size(), -1);
+    std::vector<int> parent(nodes_.size(), -1);
 
-    distance[src] = 0;
+    distance[source] = 0;
     iterTable.push_back(std::vector<int>(nodes_.size(), -1));
-    iterTable.back()[nodeMap_[src->getName()]] = 0;
+    iterTable.back()[source] = 0;
 
-    std::priority_queue<NodeDistance, std::vector<NodeDistance>, std::greater<NodeDistance>> pq;
-    pq.push({src, 0});
+    MinHeap pq;
+    pq.push({source, 0});
+    ++stats_.heapOperations;
 
     while (!pq.empty()) {
         auto top = pq.top();
         pq.pop();
-        Node* node = top.destination;
+        ++stats_.heapOperations;
+        int node = top.node;
         int dist = top.distance;
         if (dist > distance[node]) {
             continue;
         }
 
         std::vector<int> currIter = iterTable.back();
-        for (auto& edge : node->getEdges()) {
-            int newDist = dist + edge->weight;
-            if (distance[edge->destination] == -1 || newDist < distance[edge->destination]) {
-                distance[edge->destination] = newDist;
-                pq.push({edge->destination, newDist});
-                parent[edge->destination] = node;
-                currIter[nodeMap_[edge->destination->getName()]] = newDist;
+        for (int e = csr_.offsets[node]; e < csr_.offsets[node + 1]; ++e) {
+            ++stats_.relaxations;
+            int dest = csr_.targets[e];
+            int newDist = dist + csr_.weights[e];
+            if (distance[dest] == -1 || newDist < distance[dest]) {
+                distance[dest] = newDist;
+                pq.push({dest, newDist});
+                ++stats_.heapOperations;
+                parent[dest] = node;
+                currIter[dest] = newDist;
             }
         }
         iterTable.push_back(std::move(currIter));
     }
 
-    parent_ = parent;
+    forwardingTable_ = ForwardingTable(source, std::move(parent));
     iterTable.erase(iterTable.begin());
     if (iterTable.size() > 1 && iterTable.back() == iterTable[iterTable.size() - 2]) {
         iterTable.pop_back();
@@ -147,48 +266,226 @@ std::vector<std::vector<int>> Network::getLsrpTable(Node* src) {
     return iterTable;
 }
 
-std::vector<int> Network::getDvrpTable(Node* src) {
-    std::unordered_map<Node*, int> distance;
-    std::unordered_map<Node*, Node*> parent;
-    for (auto& node : nodes_) {
-        distance[node] = -1;
-        parent[node] = nullptr;
+std::vector<int> Network::getDvrpTable(Node* src, DvrpEngine engine) {
+    getCsrGraph();
+    int source = nodeMap_.at(src->getName());
+    std::vector<int> distance(nodes_.size(), INF_DISTANCE);
+    std::vector<int> parent(nodes_.size(), -1);
+    distance[source] = 0;
+
+    switch (engine) {
+    case DvrpEngine::bellmanFord:
+        runBellmanFord(distance, parent);
+        break;
+    case DvrpEngine::spfa:
+        runSpfa(source, distance, parent);
+        break;
+    case DvrpEngine::vectorized:
+        runVectorizedBellmanFord(source, distance, parent);
+        break;
     }
-    distance[src] = 0;
 
-    for (unsigned i = 0; i < nodes_.size() - 1; ++i) {
-        for (auto& node : nodes_) {
-            for (auto& edge : node->getEdges()) {
-                if (distance[node] == -1) {
-                    continue;
-                }
-                if (distance[edge->destination] == -1 || distance[node] + edge->weight < distance[edge->destination]) {
-                    distance[edge->destination] = distance[node] + edge->weight;
-                    parent[edge->destination] = node;
+    forwardingTable_ = ForwardingTable(source, std::move(parent));
+    std::replace(distance.begin(), distance.end(), INF_DISTANCE, -1);
+    return distance;
+}
+
+std::vector<int> Network::getDeltaSteppingTable(Node* src, const delta_stepping::Options& options) {
+    getCsrGraph();
+    int source = nodeMap_.at(src->getName());
+    std::vector<int> distance(nodes_.size());
+    std::vector<int> parent(nodes_.size());
+    delta_stepping::run(csr_, source, options, distance, parent, stats_);
+
+    forwardingTable_ = ForwardingTable(source, std::move(parent));
+    std::replace(distance.begin(), distance.end(), INF_DISTANCE, -1);
+    return distance;
+}
+
+DistanceMatrix Network::getAllPairsTable(int threads) {
+    DistanceMatrix matrix = getAdjacencyMatrix();
+    floyd_warshall::run(matrix, threads);
+    stats_.relaxations += static_cast<long long>(matrix.stride()) * matrix.stride() * matrix.stride();
+    return matrix;
+}
+
+EcmpTable Network::getEcmpTable(Node* src) {
+    getCsrGraph();
+    return multipath::getEcmpTable(csr_, nodeMap_.at(src->getName()), stats_);
+}
+
+std::vector<WeightedPath> Network::getKShortestPaths(Node* src, Node* dest, int k) {
+    getCsrGraph();
+    return multipath::getKShortestPaths(csr_, nodeMap_.at(src->getName()), nodeMap_.at(dest->getName()), k, stats_);
+}
+
+void Network::buildHierarchy(int threads) {
+    getCsrGraph();
+    hierarchy_ = ContractionHierarchy(csr_, threads);
+    hierarchyDirty_ = false;
+}
+
+bool Network::isHierarchyReady() const {
+    return !hierarchyDirty_;
+}
+
+int Network::getShortcutCount() const {
+    return hierarchyDirty_ ? 0 : hierarchy_.getShortcutCount();
+}
+
+WeightedPath Network::getRoute(Node* src, Node* dest) {
+    if (hierarchyDirty_) {
+        buildHierarchy();
+    }
+    return hierarchy_.getPath(nodeMap_.at(src->getName()), nodeMap_.at(dest->getName()), stats_);
+}
+
+link_state::Report Network::simulateLinkState(Node* observed, const link_state::Options& options) {
+    getCsrGraph();
+    int source = observed == nullptr ? -1 : nodeMap_.at(observed->getName());
+    link_state::Report report = link_state::run(csr_, options, source);
+    stats_.relaxations += report.stats.relaxations;
+    stats_.heapOperations += report.stats.heapOperations;
+    if (source == -1) {
+        return report;
+    }
+
+    forwardingTable_ = ForwardingTable(source, std::move(report.parent));
+    std::replace(report.distance.begin(), report.distance.end(), INF_DISTANCE, -1);
+    return report;
+}
+
+void Network::runBellmanFord(std::vector<int>& distance, std::vector<int>& parent) const {
+    int n = csr_.nodeCount();
+    bool changed = true;
+    for (int pass = 0; pass < n && changed; ++pass) {
+        changed = false;
+        for (int u = 0; u < n; ++u) {
+            if (distance[u] == INF_DISTANCE) {
+                continue;
+            }
+            stats_.relaxations += csr_.offsets[u + 1] - csr_.offsets[u];
+            for (int e = csr_.offsets[u]; e < csr_.offsets[u + 1]; ++e) {
+                int v = csr_.targets[e];
+                int newDist = distance[u] + csr_.weights[e];
+                if (newDist < distance[v]) {
+                    distance[v] = newDist;
+                    parent[v] = u;
+                    changed = true;
                 }
             }
         }
     }
+    // A relaxation in the n-th pass can only come from a negative cycle.
+    if (changed) {
+        throw std::runtime_error("Negative cycle detected");
+    }
+}
+
+void Network::runSpfa(int src, std::vector<int>& distance, std::vector<int>& parent) const {
+    int n = csr_.nodeCount();
+    std::vector<char> inQueue(n, false);
+    std::vector<int> length(n, 0); // edges on the current shortest path
+    std::queue<int> queue;
+    queue.push(src);
+    inQueue[src] = true;
+
+    while (!queue.empty()) {
+        int u = queue.front();
+        queue.pop();
+        inQueue[u] = false;
+        stats_.relaxations += csr_.offsets[u + 1] - csr_.offsets[u];
+        for (int e = csr_.offsets[u]; e < csr_.offsets[u + 1]; ++e) {
+            int v = csr_.targets[e];
+            int newDist = distance[u] + csr_.weights[e];
+            if (newDist >= distance[v]) {
+                continue;
+            }
+            distance[v] = newDist;
+            parent[v] = u;
+            // A shortest path has at most n - 1 edges, a longer one goes around a negative cycle.
+            length[v] = length[u] + 1;
+            if (length[v] >= n) {
+                throw std::runtime_error("Negative cycle detected");
+            }
+            if (!inQueue[v]) {
+                inQueue[v] = true;
+                queue.push(v);
+            }
+        }
+    }
+}
 
-    parent_ = parent;
-    std::vector<int> costs;
-    for (auto& node : nodes_) {
-        costs.push_back(distance[node]);
+// Smallest distance[u] + w(u, v) over the edges of v. Edges are stored in both
+// directions, so the out-edges of v in the CSR are also its in-edges.
+static int minIncomingDistance(const CsrGraph& csr, const std::vector<int>& distance, int v) {
+    int best = INF_DISTANCE;
+    int e = csr.offsets[v];
+    int end = csr.offsets[v + 1];
+#ifdef __AVX2__
+    const __m256i inf = _mm256_set1_epi32(INF_DISTANCE);
+    __m256i acc = inf;
+    for (; e + 8 <= end; e += 8) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&csr.targets[e]));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&csr.weights[e]));
+        __m256i d = _mm256_i32gather_epi32(distance.data(), idx, 4);
+        __m256i reachable = _mm256_cmpgt_epi32(inf, d);
+        acc = _mm256_min_epi32(acc, _mm256_blendv_epi8(inf, _mm256_add_epi32(d, w), reachable));
+    }
+    alignas(32) int lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    for (int lane : lanes) {
+        best = std::min(best, lane);
     }
-    return costs;
+#endif
+    for (; e < end; ++e) {
+        int d = distance[csr.targets[e]];
+        int candidate = (d < INF_DISTANCE) ? d + csr.weights[e] : INF_DISTANCE;
+        best = std::min(best, candidate);
+    }
+    return best;
 }
 
-std::unordered_map<std::string, std::vector<std::string>> Network::getShortestPaths() const {
-    std::unordered_map<std::string, std::vector<std::string>> paths;
-    for (auto& node : nodes_) {
-        std::vector<std::string> path;
-        Node* curr = node;
-        while (curr != nullptr) {
-            path.push_back(curr->getName());
-            curr = parent_.at(curr);
+void Network::runVectorizedBellmanFord(int src, std::vector<int>& distance, std::vector<int>& parent) const {
+    int n = csr_.nodeCount();
+    bool changed = true;
+    for (int pass = 0; pass < n && changed; ++pass) {
+        changed = false;
+        stats_.relaxations += csr_.edgeCount();
+        for (int v = 0; v < n; ++v) {
+            int best = minIncomingDistance(csr_, distance, v);
+            if (best < distance[v]) {
+                distance[v] = best;
+                changed = true;
+            }
+        }
+    }
+    if (changed) {
+        throw std::runtime_error("Negative cycle detected");
+    }
+
+    for (int v = 0; v < n; ++v) {
+        if (v == src || distance[v] == INF_DISTANCE) {
+            continue;
+        }
+        for (int e = csr_.offsets[v]; e < csr_.offsets[v + 1]; ++e) {
+            int u = csr_.targets[e];
+            if (distance[u] != INF_DISTANCE && distance[u] + csr_.weights[e] == distance[v]) {
+                parent[v] = u;
+                break;
+            }
         }
-        std::reverse(path.begin(), path.end());
-        paths[node->getName()] = path;
     }
-    return paths;
+}
+
+const RoutingStats& Network::getStats() const {
+    return stats_;
+}
+
+void Network::resetStats() {
+    stats_ = RoutingStats();
+}
+
+const ForwardingTable& Network::getForwardingTable() const {
+    return forwardingTable_;
 }
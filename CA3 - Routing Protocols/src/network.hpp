@@ -5,12 +5,28 @@
 #include <unordered_map>
 #include <vector>
 
+#include "contraction_hierarchy.hpp"
+#include "csr_graph.hpp"
+#include "delta_stepping.hpp"
+#include "distance_matrix.hpp"
+#include "edge_pool.hpp"
+#include "forwarding_table.hpp"
+#include "link_state.hpp"
+#include "multipath.hpp"
 #include "node.hpp"
+#include "shortest_path.hpp"
+#include "slab.hpp"
 
 class Network {
 public:
+    enum class DvrpEngine {
+        bellmanFord,
+        spfa,
+        vectorized,
+    };
+
     Network() = default;
-    ~Network();
+    ~Network() = default;
 
     Node* operator[](const std::string& name) const;
     Node* operator[](int index) const;
@@ -20,20 +36,54 @@ public:
     bool addEdge(const std::string& source, const std::string& destination, int weight);
     bool removeEdge(const std::string& source, const std::string& destination);
     void modifyEdge(const std::string& source, const std::string& destination, int weight);
+    void loadGraph(std::vector<std::string> names, CsrGraph csr);
 
     const std::vector<Node*>& getNodes() const;
     int getNodeIndex(const std::string& name) const;
-    std::vector<std::vector<int>> getAdjacencyMatrix() const;
+    DistanceMatrix getAdjacencyMatrix();
+    const CsrGraph& getCsrGraph();
 
     std::vector<std::vector<int>> getLsrpTable(Node* src);
-    std::vector<int> getDvrpTable(Node* src);
+    std::vector<int> getDvrpTable(Node* src, DvrpEngine engine = DvrpEngine::bellmanFord);
+    std::vector<int> getDeltaSteppingTable(Node* src, const delta_stepping::Options& options = {});
+    DistanceMatrix getAllPairsTable(int threads = 0);
+    EcmpTable getEcmpTable(Node* src);
+    std::vector<WeightedPath> getKShortestPaths(Node* src, Node* dest, int k);
+    void buildHierarchy(int threads = 0);
+    bool isHierarchyReady() const;
+    int getShortcutCount() const;
+    WeightedPath getRoute(Node* src, Node* dest);
+    link_state::Report simulateLinkState(Node* observed, const link_state::Options& options = {});
+
+    const ForwardingTable& getForwardingTable() const;
 
-    std::unordered_map<std::string, std::vector<std::string>> getShortestPaths() const;
+    const RoutingStats& getStats() const;
+    void resetStats();
 
 private:
+    Slab<Node> nodeSlab_;
     std::vector<Node*> nodes_;
     std::unordered_map<std::string, int> nodeMap_;
-    std::unordered_map<Node*, Node*> parent_;
+    ForwardingTable forwardingTable_;
+
+    // Edges of node i are linked from firstEdge_[i] to lastEdge_[i] in insertion order.
+    EdgePool edges_;
+    std::vector<int> firstEdge_;
+    std::vector<int> lastEdge_;
+
+    CsrGraph csr_;
+    bool csrDirty_ = true;
+    ContractionHierarchy hierarchy_;
+    bool hierarchyDirty_ = true;
+    mutable RoutingStats stats_;
+
+    int findEdge(int source, int destination, int& previous) const;
+    void linkEdge(int source, int destination, int weight);
+    void unlinkEdge(int source, int edge, int previous);
+
+    void runBellmanFord(std::vector<int>& distance, std::vector<int>& parent) const;
+    void runSpfa(int src, std::vector<int>& distance, std::vector<int>& parent) const;
+    void runVectorizedBellmanFord(int src, std::vector<int>& distance, std::vector<int>& parent) const;
 };
 
 #endif // NETWORK_HPP_INCLUDE
@@ -0,0 +1,281 @@
+#include "output_writer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+
+namespace {
+
+constexpr size_t FLUSH_SIZE = 1 << 16;
+
+} // namespace
+
+OutputWriter::OutputWriter(std::ostream& os, Format format, bool quiet)
+    : os_(os), format_(format), quiet_(quiet) {
+    buffer_.reserve(FLUSH_SIZE * 2);
+}
+
+OutputWriter::~OutputWriter() {
+    flush();
+}
+
+OutputWriter::Format OutputWriter::getFormat() const {
+    return format_;
+}
+
+void OutputWriter::text(const std::string& str) {
+    if (quiet_) {
+        return;
+    }
+    switch (format_) {
+    case Format::table:
+        append(str);
+        buffer_ += '\n';
+        break;
+    case Format::csv:
+        for (size_t begin = 0; begin < str.size();) {
+            size_t end = std::min(str.find('\n', begin), str.size());
+            buffer_ += "# ";
+            buffer_.append(str, begin, end - begin);
+            buffer_ += '\n';
+            begin = end + 1;
+        }
+        break;
+    case Format::binary:
+        if (!str.empty()) {
+            buffer_ += 'S';
+            appendUint32(str.size());
+            append(str);
+        }
+        break;
+    }
+    if (buffer_.size() >= FLUSH_SIZE) {
+        flush();
+    }
+}
+
+// Errors stay in the output only when it is meant to be read by a person.
+void OutputWriter::error(const std::string& str) {
+    if (format_ == Format::table && !quiet_) {
+        text(str);
+        return;
+    }
+    flush();
+    std::cerr << str << '\n';
+}
+
+void OutputWriter::beginTable(Style style, std::vector<std::string> header) {
+    style_ = style;
+    header_ = std::move(header);
+    rows_.clear();
+    if (quiet_) {
+        return;
+    }
+    switch (format_) {
+    case Format::table:
+        break;
+    case Format::csv:
+        if (style_ == Style::matrix) {
+            buffer_ += ',';
+        }
+        for (size_t i = 0; i < header_.size(); ++i) {
+            if (i != 0) {
+                buffer_ += ',';
+            }
+            appendCsvCell(header_[i]);
+        }
+        buffer_ += '\n';
+        break;
+    case Format::binary:
+        buffer_ += 'T';
+        buffer_ += static_cast<char>(style_);
+        appendUint32(header_.size());
+        for (auto& cell : header_) {
+            appendUint32(cell.size());
+            append(cell);
+        }
+        break;
+    }
+}
+
+void OutputWriter::row(std::vector<std::string> cells) {
+    if (quiet_) {
+        return;
+    }
+    switch (format_) {
+    case Format::table:
+        rows_.push_back(std::move(cells));
+        return;
+    case Format::csv:
+        for (size_t i = 0; i < cells.size(); ++i) {
+            if (i != 0) {
+                buffer_ += ',';
+            }
+            appendCsvCell(cells[i]);
+        }
+        buffer_ += '\n';
+        break;
+    case Format::binary:
+        buffer_ += 'R';
+        for (auto& cell : cells) {
+            appendUint32(cell.size());
+            append(cell);
+        }
+        break;
+    }
+    if (buffer_.size() >= FLUSH_SIZE) {
+        flush();
+    }
+}
+
+void OutputWriter::matrixRow(const std::string& label, const std::vector<int>& values) {
+    if (quiet_) {
+        return;
+    }
+    switch (format_) {
+    case Format::table: {
+        std::vector<std::string> cells;
+        cells.reserve(values.size() + 1);
+        cells.push_back(label);
+        for (int value : values) {
+            cells.push_back(std::to_string(value));
+        }
+        rows_.push_back(std::move(cells));
+        return;
+    }
+    case Format::csv:
+        appendCsvCell(label);
+        for (int value : values) {
+            buffer_ += ',';
+            appendInt(value);
+        }
+        buffer_ += '\n';
+        break;
+    case Format::binary:
+        buffer_ += 'M';
+        appendUint32(label.size());
+        append(label);
+        buffer_.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(int));
+        break;
+    }
+    if (buffer_.size() >= FLUSH_SIZE) {
+        flush();
+    }
+}
+
+void OutputWriter::endTable() {
+    if (quiet_) {
+        return;
+    }
+    if (format_ == Format::table) {
+        renderTable();
+        rows_.clear();
+    }
+    else if (format_ == Format::binary) {
+        buffer_ += 'E';
+    }
+    if (buffer_.size() >= FLUSH_SIZE) {
+        flush();
+    }
+}
+
+void OutputWriter::flush() {
+    if (!buffer_.empty()) {
+        os_.write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+    os_.flush();
+}
+
+void OutputWriter::append(const std::string& str) {
+    buffer_ += str;
+}
+
+void OutputWriter::appendInt(long long value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, result.ptr);
+}
+
+void OutputWriter::appendUint32(uint32_t value) {
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void OutputWriter::appendCsvCell(const std::string& cell) {
+    if (cell.find_first_of(",\"\n") == std::string::npos) {
+        append(cell);
+        return;
+    }
+    buffer_ += '"';
+    for (char c : cell) {
+        if (c == '"') {
+            buffer_ += '"';
+        }
+        buffer_ += c;
+    }
+    buffer_ += '"';
+}
+
+void OutputWriter::appendPadded(const std::string& str, int width, bool center) {
+    int padding = std::max<int>(0, width - str.size());
+    int left = center ? padding / 2 : padding;
+    buffer_.append(left, ' ');
+    append(str);
+    buffer_.append(padding - left, ' ');
+}
+
+void OutputWriter::renderTable() {
+    int maxLen = 0;
+    for (auto& cell : header_) {
+        maxLen = std::max<int>(maxLen, cell.size());
+    }
+    for (auto& row : rows_) {
+        for (auto& cell : row) {
+            maxLen = std::max<int>(maxLen, cell.size());
+        }
+    }
+
+    if (style_ == Style::matrix) {
+        size_t start = buffer_.size();
+        buffer_.append(maxLen, ' ');
+        buffer_ += " | ";
+        for (auto& cell : header_) {
+            appendPadded(cell, maxLen, false);
+            buffer_ += ' ';
+        }
+        size_t lineLen = buffer_.size() - start;
+        buffer_ += '\n';
+        buffer_.append(lineLen, '-');
+        buffer_ += '\n';
+        for (auto& row : rows_) {
+            for (size_t i = 0; i < row.size(); ++i) {
+                appendPadded(row[i], maxLen, false);
+                buffer_ += i == 0 ? " | " : " ";
+            }
+            buffer_ += '\n';
+            if (buffer_.size() >= FLUSH_SIZE) {
+                flush();
+            }
+        }
+        return;
+    }
+
+    auto appendRow = [this, maxLen](const std::vector<std::string>& row) {
+        for (auto& cell : row) {
+            appendPadded(cell, maxLen, true);
+            buffer_ += " | ";
+        }
+        buffer_ += '\n';
+    };
+    appendRow(header_);
+    if (style_ == Style::grid) {
+        buffer_.append((maxLen + 3) * header_.size(), '-');
+        buffer_ += '\n';
+    }
+    for (auto& row : rows_) {
+        appendRow(row);
+        if (buffer_.size() >= FLUSH_SIZE) {
+            flush();
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef OUTPUT_WRITER_HPP_INCLUDE
+#define OUTPUT_WRITER_HPP_INCLUDE
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Buffered sink for the CLI output. Tables are streamed row by row: csv and
+// binary rows are encoded straight into the buffer, only the aligned ASCII
+// rendering of the table format has to keep the rows until the table ends.
+class OutputWriter {
+public:
+    enum class Format {
+        table,
+        csv,    // tables as comma separated rows, text lines prefixed with "# "
+        binary, // tagged records, see README
+    };
+
+    enum class Style {
+        grid,   // centered cells with a line under the header
+        plain,  // centered cells
+        matrix, // right aligned cells with the header repeated as row labels
+    };
+
+    OutputWriter(std::ostream& os, Format format = Format::table, bool quiet = false);
+    ~OutputWriter();
+
+    Format getFormat() const;
+
+    void text(const std::string& str);
+    void error(const std::string& str);
+
+    void beginTable(Style style, std::vector<std::string> header);
+    void row(std::vector<std::string> cells);
+    void matrixRow(const std::string& label, const std::vector<int>& values);
+    void endTable();
+
+    void flush();
+
+private:
+    std::ostream& os_;
+    Format format_;
+    bool quiet_;
+    std::string buffer_;
+
+    Style style_ = Style::grid;
+    std::vector<std::string> header_;
+    std::vector<std::vector<std::string>> rows_;
+
+    void append(const std::string& str);
+    void appendInt(long long value);
+    void appendUint32(uint32_t value);
+    void appendCsvCell(const std::string& cell);
+    void appendPadded(const std::string& str, int width, bool center);
+    void renderTable();
+};
+
+#endif // OUTPUT_WRITER_HPP_INCLUDE
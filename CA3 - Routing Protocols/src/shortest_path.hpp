@@ -0,0 +1,27 @@
+#ifndef SHORTEST_PATH_HPP_INCLUDE
+#define SHORTEST_PATH_HPP_INCLUDE
+
+#include <functional>
+#include <queue>
+#include <vector>
+
+struct RoutingStats {
+    long long relaxations = 0;
+    long long heapOperations = 0;
+};
+
+struct NodeDistance {
+    int node;
+    int distance;
+
+    bool operator<(const NodeDistance& other) const {
+        return distance < other.distance;
+    }
+    bool operator>(const NodeDistance& other) const {
+        return distance > other.distance;
+    }
+};
+
+using MinHeap = std::priority_queue<NodeDistance, std::vector<NodeDistance>, std::greater<NodeDistance>>;
+
+#endif // SHORTEST_PATH_HPP_INCLUDE
@@ -0,0 +1,60 @@
+#ifndef SLAB_HPP_INCLUDE
+#define SLAB_HPP_INCLUDE
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Append-only storage in fixed-size blocks which hands out integer handles.
+// Objects never move, so pointers to them stay valid until clear(), which
+// destroys everything and frees one allocation per block.
+template <typename T>
+class Slab {
+public:
+    static constexpr int BLOCK_SIZE = 4096;
+
+    Slab() = default;
+    Slab(const Slab&) = delete;
+    Slab& operator=(const Slab&) = delete;
+    ~Slab() { clear(); }
+
+    template <typename... Args>
+    int emplace(Args&&... args) {
+        if (size_ == static_cast<int>(blocks_.size()) * BLOCK_SIZE) {
+            blocks_.emplace_back(new Storage[BLOCK_SIZE]);
+        }
+        new (address(size_)) T(std::forward<Args>(args)...);
+        return size_++;
+    }
+
+    T& operator[](int handle) { return *std::launder(address(handle)); }
+    const T& operator[](int handle) const { return *std::launder(address(handle)); }
+
+    int size() const { return size_; }
+
+    void clear() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (int i = 0; i < size_; ++i) {
+                (*this)[i].~T();
+            }
+        }
+        blocks_.clear();
+        size_ = 0;
+    }
+
+private:
+    struct Storage {
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Storage[]>> blocks_;
+    int size_ = 0;
+
+    T* address(int handle) const {
+        return reinterpret_cast<T*>(blocks_[handle / BLOCK_SIZE][handle % BLOCK_SIZE].bytes);
+    }
+};
+
+#endif // SLAB_HPP_INCLUDE
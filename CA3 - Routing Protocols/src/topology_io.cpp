@@ -0,0 +1,401 @@
+#include "topology_io.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace topology_io {
+
+namespace {
+
+constexpr uint32_t BINARY_MAGIC = 0x504F5452; // "RTOP"
+constexpr uint32_t BINARY_VERSION = 1;
+constexpr size_t MIN_CHUNK_BYTES = 1 << 20;
+constexpr int MAX_FIELDS = 3;
+
+class MappedFile {
+public:
+    MappedFile(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ == -1) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd_, &st) == -1) {
+            ::close(fd_);
+            throw std::runtime_error("Cannot stat " + path);
+        }
+        size_ = st.st_size;
+        if (size_ == 0) {
+            return;
+        }
+        data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (data_ == MAP_FAILED) {
+            ::close(fd_);
+            throw std::runtime_error("Cannot map " + path);
+        }
+        ::madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+    ~MappedFile() {
+        if (size_ != 0) {
+            ::munmap(data_, size_);
+        }
+        ::close(fd_);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return static_cast<const char*>(data_); }
+    size_t size() const { return size_; }
+
+private:
+    int fd_ = -1;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+struct Chunk {
+    std::string_view text;
+    std::vector<std::string_view> names;
+    std::vector<CsrEdge> edges;
+    int lines = 0;
+    int errorLine = 0;
+    std::string error;
+    int skippedEdges = 0;
+};
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+std::string_view trim(std::string_view str) {
+    while (!str.empty() && isSpace(str.front())) str.remove_prefix(1);
+    while (!str.empty() && isSpace(str.back())) str.remove_suffix(1);
+    return str;
+}
+
+// Accepts "12" or "2.5" (rounded half up, at least 1).
+bool parseWeight(std::string_view str, int& weight) {
+    long long value = 0;
+    unsigned i = 0;
+    for (; i < str.size() && str[i] >= '0' && str[i] <= '9'; ++i) {
+        value = value * 10 + (str[i] - '0');
+        if (value >= INF_DISTANCE) {
+            return false;
+        }
+    }
+    if (i == 0) {
+        return false;
+    }
+    bool fractional = false;
+    if (i < str.size() && str[i] == '.') {
+        fractional = true;
+        ++i;
+        if (i < str.size() && str[i] >= '5' && str[i] <= '9') {
+            ++value;
+        }
+        while (i < str.size() && str[i] >= '0' && str[i] <= '9') ++i;
+    }
+    if (i != str.size()) {
+        return false;
+    }
+    if (value == 0 && fractional) {
+        value = 1;
+    }
+    if (value <= 0) {
+        return false;
+    }
+    weight = static_cast<int>(value);
+    return true;
+}
+
+int splitFields(std::string_view line, Format format, std::string_view (&fields)[MAX_FIELDS]) {
+    int count = 0;
+    if (format == Format::csv || format == Format::caida) {
+        char delim = (format == Format::csv) ? ',' : '|';
+        while (count < MAX_FIELDS) {
+            size_t pos = line.find(delim);
+            fields[count++] = trim(line.substr(0, pos));
+            if (pos == std::string_view::npos) break;
+            line.remove_prefix(pos + 1);
+        }
+        return count;
+    }
+
+    while (count < MAX_FIELDS) {
+        while (!line.empty() && isSpace(line.front())) line.remove_prefix(1);
+        if (line.empty()) break;
+        size_t end = 0;
+        while (end < line.size() && !isSpace(line[end])) ++end;
+        fields[count++] = line.substr(0, end);
+        line.remove_prefix(end);
+    }
+    if (count == 1 && format == Format::edgeList) {
+        std::string_view token = fields[0];
+        count = 0;
+        while (count < MAX_FIELDS && !token.empty()) {
+            size_t pos = token.find('-');
+            fields[count++] = token.substr(0, pos);
+            if (pos == std::string_view::npos) break;
+            token.remove_prefix(pos + 1);
+        }
+    }
+    return count;
+}
+
+void parseChunk(Chunk& chunk, Format format, bool allowHeader) {
+    std::unordered_map<std::string_view, int> ids;
+    auto intern = [&](std::string_view name) {
+        auto it = ids.try_emplace(name, static_cast<int>(chunk.names.size()));
+        if (it.second) {
+            chunk.names.push_back(name);
+        }
+        return it.first->second;
+    };
+
+    std::string_view text = chunk.text;
+    std::string_view fields[MAX_FIELDS];
+    while (!text.empty()) {
+        size_t eol = text.find('\n');
+        std::string_view line = trim(text.substr(0, eol));
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+        ++chunk.lines;
+
+        if (line.empty() || line[0] == '#' || line[0] == '%') {
+            continue;
+        }
+
+        int count = splitFields(line, format, fields);
+        int weight = 1;
+        bool valid = count >= 2 && !fields[0].empty() && !fields[1].empty();
+        if (valid && count == 3 && format != Format::caida) {
+            valid = parseWeight(fields[2], weight);
+        }
+        if (!valid) {
+            if (allowHeader && chunk.lines == 1 && format == Format::csv) {
+                continue;
+            }
+            chunk.errorLine = chunk.lines;
+            chunk.error = "Malformed edge";
+            return;
+        }
+        if (fields[0] == fields[1]) {
+            ++chunk.skippedEdges;
+            continue;
+        }
+        chunk.edges.push_back({intern(fields[0]), intern(fields[1]), weight});
+    }
+}
+
+std::vector<Chunk> splitChunks(std::string_view text) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t count = std::max<size_t>(1, std::min<size_t>(threads, text.size() / MIN_CHUNK_BYTES));
+
+    std::vector<Chunk> chunks;
+    size_t begin = 0;
+    for (size_t i = 0; i < count && begin < text.size(); ++i) {
+        size_t end = (i == count - 1) ? text.size() : text.size() * (i + 1) / count;
+        end = std::max(end, begin);
+        size_t eol = text.find('\n', end);
+        end = (eol == std::string_view::npos) ? text.size() : eol + 1;
+        Chunk chunk;
+        chunk.text = text.substr(begin, end - begin);
+        chunks.push_back(std::move(chunk));
+        begin = end;
+    }
+    return chunks;
+}
+
+Topology parseText(std::string_view text, Format format) {
+    std::vector<Chunk> chunks = splitChunks(text);
+    if (chunks.size() == 1) {
+        parseChunk(chunks[0], format, true);
+    }
+    else {
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < chunks.size(); ++i) {
+            workers.emplace_back(parseChunk, std::ref(chunks[i]), format, i == 0);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    int lineBase = 0;
+    for (auto& chunk : chunks) {
+        if (chunk.errorLine != 0) {
+            throw std::runtime_error(chunk.error + " at line " + std::to_string(lineBase + chunk.errorLine));
+        }
+        lineBase += chunk.lines;
+    }
+
+    Topology topology;
+    std::unordered_map<std::string_view, int> ids;
+    std::vector<int> remap;
+    for (auto& chunk : chunks) {
+        remap.resize(chunk.names.size());
+        for (unsigned i = 0; i < chunk.names.size(); ++i) {
+            auto it = ids.try_emplace(chunk.names[i], static_cast<int>(topology.names.size()));
+            if (it.second) {
+                topology.names.emplace_back(chunk.names[i]);
+            }
+            remap[i] = it.first->second;
+        }
+        for (auto& edge : chunk.edges) {
+            edge.source = remap[edge.source];
+            edge.destination = remap[edge.destination];
+        }
+        topology.skippedEdges += chunk.skippedEdges;
+    }
+
+    std::vector<CsrEdge> edges;
+    if (chunks.size() == 1) {
+        edges = std::move(chunks[0].edges);
+    }
+    else {
+        for (auto& chunk : chunks) {
+            edges.insert(edges.end(), chunk.edges.begin(), chunk.edges.end());
+            std::vector<CsrEdge>().swap(chunk.edges);
+        }
+    }
+
+    int duplicates = 0;
+    topology.csr = buildCsrGraph(topology.names.size(), edges, duplicates);
+    topology.skippedEdges += duplicates;
+    return topology;
+}
+
+template <typename T>
+void readRaw(const char*& pos, const char* end, T* out, size_t count) {
+    size_t bytes = sizeof(T) * count;
+    if (static_cast<size_t>(end - pos) < bytes) {
+        throw std::runtime_error("Truncated topology file");
+    }
+    std::memcpy(out, pos, bytes);
+    pos += bytes;
+}
+
+Topology parseBinary(const char* data, size_t size) {
+    const char* pos = data;
+    const char* end = data + size;
+    uint32_t header[4];
+    readRaw(pos, end, header, 4);
+    if (header[1] != BINARY_VERSION) {
+        throw std::runtime_error("Unsupported topology file version");
+    }
+
+    // Every name takes at least its length and every edge a target and a weight,
+    // so the counts can be checked before allocating for them.
+    if (header[2] >= static_cast<uint32_t>(INF_DISTANCE) || header[3] >= static_cast<uint32_t>(INF_DISTANCE) ||
+        header[2] > (size - sizeof(header)) / sizeof(uint32_t) || header[3] > size / (2 * sizeof(int32_t))) {
+        throw std::runtime_error("Corrupted topology file");
+    }
+
+    Topology topology;
+    topology.names.resize(header[2]);
+    for (auto& name : topology.names) {
+        uint32_t len;
+        readRaw(pos, end, &len, 1);
+        name.resize(len);
+        readRaw(pos, end, name.data(), len);
+    }
+    topology.csr.offsets.resize(header[2] + 1);
+    topology.csr.targets.resize(header[3]);
+    topology.csr.weights.resize(header[3]);
+    readRaw(pos, end, topology.csr.offsets.data(), topology.csr.offsets.size());
+    readRaw(pos, end, topology.csr.targets.data(), topology.csr.targets.size());
+    readRaw(pos, end, topology.csr.weights.data(), topology.csr.weights.size());
+    // The graph is built from these arrays without further checks.
+    const CsrGraph& csr = topology.csr;
+    int nodeCount = header[2];
+    bool valid = csr.offsets.front() == 0 && csr.offsets.back() == static_cast<int>(header[3]);
+    for (int u = 0; u < nodeCount && valid; ++u) {
+        valid = csr.offsets[u] <= csr.offsets[u + 1];
+    }
+    for (int u = 0; u < nodeCount && valid; ++u) {
+        for (int e = csr.offsets[u]; e < csr.offsets[u + 1] && valid; ++e) {
+            valid = csr.targets[e] >= 0 && csr.targets[e] < nodeCount && csr.targets[e] != u &&
+                    csr.weights[e] > 0 && csr.weights[e] < INF_DISTANCE;
+        }
+    }
+    if (!valid) {
+        throw std::runtime_error("Corrupted topology file");
+    }
+    return topology;
+}
+
+template <typename T>
+void appendRaw(std::string& buffer, const T* data, size_t count) {
+    buffer.append(reinterpret_cast<const char*>(data), sizeof(T) * count);
+}
+
+} // namespace
+
+bool parseFormat(const std::string& name, Format& format) {
+    static const std::unordered_map<std::string, Format> formats = {
+        {"edges", Format::edgeList},
+        {"csv", Format::csv},
+        {"rocketfuel", Format::rocketfuel},
+        {"caida", Format::caida},
+    };
+    auto it = formats.find(name);
+    if (it == formats.end()) {
+        return false;
+    }
+    format = it->second;
+    return true;
+}
+
+Format guessFormat(const std::string& path) {
+    auto endsWith = [&path](const std::string& suffix) {
+        return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (endsWith(".csv")) return Format::csv;
+    if (endsWith(".intra") || endsWith(".weights")) return Format::rocketfuel;
+    if (path.find("as-rel") != std::string::npos) return Format::caida;
+    return Format::edgeList;
+}
+
+Topology load(const std::string& path, Format format) {
+    MappedFile file(path);
+    uint32_t magic = 0;
+    if (file.size() >= sizeof(magic)) {
+        std::memcpy(&magic, file.data(), sizeof(magic));
+    }
+    if (magic == BINARY_MAGIC) {
+        return parseBinary(file.data(), file.size());
+    }
+    return parseText(std::string_view(file.data(), file.size()), format);
+}
+
+void save(const std::string& path, const std::vector<std::string>& names, const CsrGraph& csr) {
+    std::string buffer;
+    uint32_t header[4] = {BINARY_MAGIC, BINARY_VERSION,
+                          static_cast<uint32_t>(names.size()), static_cast<uint32_t>(csr.edgeCount())};
+    appendRaw(buffer, header, 4);
+    for (auto& name : names) {
+        uint32_t len = name.size();
+        appendRaw(buffer, &len, 1);
+        buffer += name;
+    }
+    appendRaw(buffer, csr.offsets.data(), csr.offsets.size());
+    appendRaw(buffer, csr.targets.data(), csr.targets.size());
+    appendRaw(buffer, csr.weights.data(), csr.weights.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.write(buffer.data(), buffer.size())) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+} // namespace topology_io
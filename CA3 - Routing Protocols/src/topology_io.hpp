@@ -0,0 +1,34 @@
+#ifndef TOPOLOGY_IO_HPP_INCLUDE
+#define TOPOLOGY_IO_HPP_INCLUDE
+
+#include <string>
+#include <vector>
+
+#include "csr_graph.hpp"
+
+namespace topology_io {
+
+enum class Format {
+    edgeList,   // <s> <d> [<w>], also accepts <s>-<d>-<w>
+    csv,        // <s>,<d>[,<w>] with an optional header line
+    rocketfuel, // <s> <d> <w> where w may be fractional
+    caida,      // <s>|<d>|<relationship>, every link has weight 1
+};
+
+struct Topology {
+    std::vector<std::string> names;
+    CsrGraph csr;
+    int skippedEdges = 0;
+};
+
+bool parseFormat(const std::string& name, Format& format);
+Format guessFormat(const std::string& path);
+
+// Binary files written by save() are detected by their magic number
+// and loaded regardless of the given format.
+Topology load(const std::string& path, Format format);
+void save(const std::string& path, const std::vector<std::string>& names, const CsrGraph& csr);
+
+} // namespace topology_io
+
+#endif // TOPOLOGY_IO_HPP_INCLUDE
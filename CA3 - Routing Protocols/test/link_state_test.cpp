@@ -0,0 +1,64 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "csr_graph.hpp"
+#include "link_state.hpp"
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& name) {
+    if (!condition) {
+        std::cerr << "FAILED: " << name << '\n';
+        ++failures;
+    }
+}
+
+// 0 -4- 1 -1- 2 -2- 3, and 0 -7- 2.
+CsrGraph makeGraph() {
+    std::vector<CsrEdge> edges = {{0, 1, 4}, {1, 2, 1}, {0, 2, 7}, {2, 3, 2}};
+    int duplicates = 0;
+    return buildCsrGraph(4, edges, duplicates);
+}
+
+// The LSAs of the cold start are far older than maxAge when the events happen,
+// so the routes after them rely on the refreshed LSAs.
+void testEventsAfterMaxAge(int threads) {
+    std::string name = "events after max age, " + std::to_string(threads) + " threads";
+    link_state::Options options;
+    options.threads = threads;
+    options.maxAge = 100;
+    options.events = {{500, 0, 2, 1}, {700, 1, 2, 0}};
+
+    link_state::Report report = link_state::run(makeGraph(), options, 0);
+    check(report.finishedAt >= 700, name + ": runs until the last event");
+    check(report.distance == std::vector<int>({0, 4, 1, 3}), name + ": distances");
+    check(report.parent == std::vector<int>({-1, 0, 0, 2}), name + ": parents");
+}
+
+// Refreshes do not rerun SPF when no link changed.
+void testRefreshWithoutChanges() {
+    link_state::Options options;
+    options.maxAge = 10;
+    options.events = {{100, 0, 1, 4}};
+
+    link_state::Report report = link_state::run(makeGraph(), options, 3);
+    check(report.originated > 4, "refresh without changes: LSAs are refreshed");
+    check(report.spfRuns == 4, "refresh without changes: one SPF run per router");
+    check(report.distance == std::vector<int>({7, 3, 2, 0}), "refresh without changes: distances");
+}
+
+} // namespace
+
+int main() {
+    testEventsAfterMaxAge(1);
+    testEventsAfterMaxAge(4);
+    testRefreshWithoutChanges();
+    if (failures != 0) {
+        return 1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
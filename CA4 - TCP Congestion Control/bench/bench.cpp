@@ -0,0 +1,314 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "algorithms.hpp"
+#include "bbr.hpp"
+#include "loss_model.hpp"
+#include "new_reno.hpp"
+#include "reno.hpp"
+#include "scenario.hpp"
+#include "simulator.hpp"
+#include "utils.hpp"
+
+namespace {
+
+const std::string USAGE = "Usage: bench.out [--filter=<substring>] [--min-time=<s>] [--repetitions=<n>]";
+
+// Effectively endless transfer for the benchmarks that call the callbacks directly.
+constexpr int ENDLESS = std::numeric_limits<int>::max() / 2;
+
+template <typename T>
+void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs the given number of iterations and returns their ns. Benchmarks that
+// time themselves return the sum of the timed parts only.
+using Body = std::function<long long(long long iterations)>;
+
+struct Benchmark {
+    std::string name;
+    Body body;
+    double itemsPerIteration = 0.0; // 0 when the benchmark has no items
+};
+
+struct Result {
+    std::string name;
+    long long iterations;
+    double realTime; // ns per iteration
+    double cpuTime;  // ns per iteration
+    double itemsPerSecond;
+};
+
+long long elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+Body timed(std::function<void()> op) {
+    return [op](long long iterations) {
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i) {
+            op();
+        }
+        return elapsedNs(start);
+    };
+}
+
+// Grows the iteration count until a batch takes minTime, like Google Benchmark.
+Result measure(const Benchmark& benchmark, double minTime) {
+    long long minNs = std::llround(minTime * NS_PER_SEC);
+    long long iterations = 1;
+    while (true) {
+        std::clock_t cpuStart = std::clock();
+        long long ns = benchmark.body(iterations);
+        double cpuNs = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC * NS_PER_SEC;
+        if (ns >= minNs || iterations >= (1LL << 40)) {
+            Result result{benchmark.name, iterations, static_cast<double>(ns) / iterations, cpuNs / iterations, 0.0};
+            if (benchmark.itemsPerIteration > 0 && ns > 0) {
+                result.itemsPerSecond = benchmark.itemsPerIteration * iterations / ns * NS_PER_SEC;
+            }
+            return result;
+        }
+        double scale = ns > 0 ? 1.4 * minNs / ns : 100.0;
+        iterations = std::max(iterations + 1, static_cast<long long>(iterations * std::min(scale, 100.0)));
+    }
+}
+
+// Brings a connection out of its start up phase with rounds of the round model.
+void warmUp(TcpConnection& connection, int rounds) {
+    for (int i = 0; i < rounds; ++i) {
+        connection.sendData();
+        if (!connection.onPacketLoss()) {
+            connection.onRttUpdate();
+        }
+    }
+}
+
+std::vector<Benchmark> makeBenchmarks() {
+    std::vector<Benchmark> benchmarks;
+
+    // Per RTT callbacks of the round model. Reno is held in a sawtooth below the
+    // receive window, and BBR is warmed up past startup where its window stays bounded.
+    benchmarks.push_back({"reno/on_rtt_update", [](long long iterations) {
+        Reno reno(ENDLESS);
+        warmUp(reno, 100);
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i) {
+            reno.onRttUpdate();
+            if (reno.getWindowSize() >= reno.getReceiveWindow()) {
+                reno.onLoss(LossEvent::tripleDupAck);
+            }
+        }
+        doNotOptimize(reno.getWindowSize());
+        return elapsedNs(start);
+    }});
+    benchmarks.push_back({"bbr/on_rtt_update", [](long long iterations) {
+        Bbr bbr(ENDLESS);
+        warmUp(bbr, 100);
+        while (bbr.getPhase() == Phase::startup || bbr.getPhase() == Phase::drain) {
+            warmUp(bbr, 1);
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i) {
+            bbr.onRttUpdate();
+        }
+        doNotOptimize(bbr.getWindowSize());
+        return elapsedNs(start);
+    }});
+    // One window per call, with the loss draws. Only sendData is timed; the rest
+    // of the round keeps the window as it is in a run.
+    benchmarks.push_back({"newreno/send_data", [](long long iterations) {
+        NewReno newReno(ENDLESS);
+        long long ns = 0;
+        for (long long i = 0; i < iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            newReno.sendData();
+            ns += elapsedNs(start);
+            if (!newReno.onPacketLoss()) {
+                newReno.onRttUpdate();
+            }
+        }
+        return ns;
+    }});
+
+    // Per ack callbacks of the event driven model: new acks of one packet every
+    // 12 us with an rtt of 40 ms.
+    auto makeAck = [](long long i, int inflight) {
+        constexpr long long INTERVAL = 12000;
+        constexpr long long RTT = 40 * NS_PER_MS;
+        double rate = static_cast<double>(NS_PER_SEC) / INTERVAL;
+        return AckEvent{i * INTERVAL, RTT, 1, inflight, i + 1, false, rate, i + 1 - inflight};
+    };
+    benchmarks.push_back({"reno/on_ack", [makeAck](long long iterations) {
+        Reno reno(ENDLESS);
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i) {
+            doNotOptimize(reno.onAck(makeAck(i, reno.getWindowSize())));
+        }
+        return elapsedNs(start);
+    }});
+    benchmarks.push_back({"bbr/on_ack", [makeAck](long long iterations) {
+        Bbr bbr(ENDLESS);
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i) {
+            doNotOptimize(bbr.onAck(makeAck(i, bbr.getWindowSize())));
+        }
+        return elapsedNs(start);
+    }});
+
+    // Random numbers, per value or per packet decision.
+    auto gen = std::make_shared<Philox>(1);
+    benchmarks.push_back({"utils/rand_int", timed([gen]() {
+        doNotOptimize(utils::randInt(*gen, 20, 200));
+    })});
+    auto buffer = std::make_shared<std::vector<Philox::result_type>>(1024);
+    benchmarks.push_back({"philox/fill_1024", timed([gen, buffer]() {
+        gen->fill(buffer->data(), buffer->size());
+        doNotOptimize(buffer->front());
+    }), 1024});
+    std::shared_ptr<loss::Model> bernoulli = loss::make("bernoulli:0.01", BottleneckLink::Config{}, 1);
+    benchmarks.push_back({"loss/bernoulli_next", timed([bernoulli]() {
+        doNotOptimize(bernoulli->next());
+    })});
+    std::shared_ptr<loss::Model> ge = loss::make("ge:0.01:0.3", BottleneckLink::Config{}, 1);
+    benchmarks.push_back({"loss/gilbert_elliott_next", timed([ge]() {
+        doNotOptimize(ge->next());
+    })});
+
+    // Whole runs of the default scenarios, items are packets.
+    constexpr int PACKETS = 100000;
+    for (const char* name : {"reno", "newreno", "bbr", "cubic"}) {
+        std::string algorithm = name;
+        benchmarks.push_back({"rounds/" + algorithm, timed([algorithm]() {
+            auto connection = algorithms::make(algorithm, PACKETS, 1, std::numeric_limits<int>::max());
+            doNotOptimize(connection->runRounds(nullptr).rounds);
+        }), PACKETS});
+    }
+    for (const char* name : {"newreno", "bbr"}) {
+        std::string algorithm = name;
+        benchmarks.push_back({"events/" + algorithm, timed([algorithm]() {
+            auto connection = algorithms::make(algorithm, PACKETS, 1, std::numeric_limits<int>::max());
+            Simulator simulator(BottleneckLink::Config{});
+            simulator.addFlow(*connection);
+            doNotOptimize(simulator.run().events);
+        }), PACKETS});
+    }
+    benchmarks.push_back({"flows/reno_4_bbr_4", timed([]() {
+        scenario::Options options;
+        options.groups = {{"reno", 4}, {"bbr", 4}};
+        options.packets = PACKETS / 8;
+        options.rttSpread = 20 * NS_PER_MS;
+        doNotOptimize(scenario::run(options).fairness);
+    }), PACKETS});
+    return benchmarks;
+}
+
+void writeString(std::ostream& os, const std::string& value) {
+    os << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') os << '\\';
+        os << c;
+    }
+    os << '"';
+}
+
+// Same layout as the JSON of Google Benchmark, so its tools can compare two runs.
+void writeJson(std::ostream& os, const std::vector<Result>& results, int repetitions) {
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+    os << std::setprecision(6) << "{\n"
+       << "  \"context\": {\n"
+       << "    \"date\": \"" << date << "\",\n"
+       << "    \"executable\": \"bench.out\",\n"
+       << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+       << "    \"repetitions\": " << repetitions << ",\n"
+       << "    \"library_build_type\": \"release\"\n"
+       << "  },\n"
+       << "  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        os << (i == 0 ? "\n" : ",\n") << "    {\n"
+           << "      \"name\": ";
+        writeString(os, result.name);
+        os << ",\n      \"run_name\": ";
+        writeString(os, result.name);
+        os << ",\n      \"run_type\": \"iteration\",\n"
+           << "      \"iterations\": " << result.iterations << ",\n"
+           << "      \"real_time\": " << result.realTime << ",\n"
+           << "      \"cpu_time\": " << result.cpuTime << ",\n"
+           << "      \"time_unit\": \"ns\"";
+        if (result.itemsPerSecond > 0) {
+            os << ",\n      \"items_per_second\": " << result.itemsPerSecond;
+        }
+        os << "\n    }";
+    }
+    os << "\n  ]\n}\n";
+}
+
+bool parseValue(const std::string& arg, const std::string& name, std::string& value) {
+    if (arg.rfind(name, 0) != 0) return false;
+    value = arg.substr(name.size());
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    double minTime = 0.5;
+    int repetitions = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value;
+        try {
+            if (parseValue(arg, "--filter=", value)) {
+                filter = value;
+            }
+            else if (parseValue(arg, "--min-time=", value)) {
+                minTime = std::stod(value);
+            }
+            else if (parseValue(arg, "--repetitions=", value)) {
+                repetitions = std::stoi(value);
+            }
+            else {
+                minTime = -1;
+            }
+        }
+        catch (const std::exception&) {
+            minTime = -1;
+        }
+    }
+    if (minTime <= 0 || repetitions < 1) {
+        std::cerr << USAGE << std::endl;
+        return 1;
+    }
+
+    // The JSON goes to stdout and a table to stderr while the benchmarks run.
+    std::vector<Result> results;
+    for (auto& benchmark : makeBenchmarks()) {
+        if (benchmark.name.find(filter) == std::string::npos) continue;
+        for (int i = 0; i < repetitions; ++i) {
+            Result result = measure(benchmark, minTime);
+            std::cerr << std::left << std::setw(28) << result.name << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(16) << result.realTime << " ns"
+                      << std::setw(14) << result.iterations;
+            if (result.itemsPerSecond > 0) {
+                std::cerr << std::setprecision(3) << std::setw(12) << result.itemsPerSecond / 1e6 << " M/s";
+            }
+            std::cerr << std::endl;
+            results.push_back(result);
+        }
+    }
+    writeJson(std::cout, results, repetitions);
+    return 0;
+}
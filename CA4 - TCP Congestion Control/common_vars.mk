@@ -1,5 +1,6 @@
 CXX       = g++
 CXXFLAGS += -Wall -pedantic
+CXXFLAGS += -O2 -pthread
 CXX      += $(CXXFLAGS)
 CPPFLAGS += -std=c++17
 
@@ -0,0 +1,65 @@
+#include "algorithms.hpp"
+
+#include "bbr.hpp"
+#include "congestion_ops.hpp"
+#include "cubic.hpp"
+#include "new_reno.hpp"
+#include "reno.hpp"
+#include "vegas.hpp"
+#include "westwood.hpp"
+
+namespace algorithms {
+
+namespace {
+
+using Factory = std::unique_ptr<TcpConnection> (*)(int packets, int cwnd, int thold);
+
+template <typename T>
+std::unique_ptr<TcpConnection> construct(int packets, int cwnd, int thold) {
+    return std::make_unique<T>(packets, cwnd, thold);
+}
+
+struct Entry {
+    const char* name;
+    Factory factory;
+};
+
+// BBR has its own round model, the others are window policies
+// (congestion_ops.hpp) on the shared one.
+const Entry REGISTRY[] = {
+    {"reno", construct<Reno>},
+    {"newreno", construct<NewReno>},
+    {"bbr", construct<Bbr>},
+    {"cubic", construct<PolicyConnection<Cubic>>},
+    {"vegas", construct<PolicyConnection<Vegas>>},
+    {"westwood", construct<PolicyConnection<Westwood>>},
+};
+
+const Entry* find(const std::string& name) {
+    for (const Entry& entry : REGISTRY) {
+        if (name == entry.name) return &entry;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+std::vector<std::string> names() {
+    std::vector<std::string> result;
+    for (const Entry& entry : REGISTRY) {
+        result.push_back(entry.name);
+    }
+    return result;
+}
+
+bool exists(const std::string& name) {
+    return find(name) != nullptr;
+}
+
+std::unique_ptr<TcpConnection> make(const std::string& name, int packets, int cwnd, int thold) {
+    const Entry* entry = find(name);
+    if (entry == nullptr) return nullptr;
+    return entry->factory(packets, cwnd, thold);
+}
+
+} // namespace algorithms
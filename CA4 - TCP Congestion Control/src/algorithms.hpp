@@ -0,0 +1,21 @@
+#ifndef ALGORITHMS_HPP_INCLUDE
+#define ALGORITHMS_HPP_INCLUDE
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tcp_connection.hpp"
+
+namespace algorithms {
+
+// Registered names, in the order they are listed.
+std::vector<std::string> names();
+bool exists(const std::string& name);
+
+// Returns nullptr for an unknown name.
+std::unique_ptr<TcpConnection> make(const std::string& name, int packets, int cwnd, int thold);
+
+} // namespace algorithms
+
+#endif // ALGORITHMS_HPP_INCLUDE
@@ -4,29 +4,29 @@
 
 void Bbr::sendData() {
     if (timeout_ != 0) return;
-    if (sw_.lastAck == static_cast<int>(packets_.size()) - 1) return;
+    if (sw_.lastAck == packetCount_ - 1) return;
 
     lostAny_ = false;
     int startAck = sw_.lastAck + 1;
-    for (int i = startAck; i < startAck + cwnd_ && i < static_cast<int>(packets_.size()); ++i) {
+    for (int i = startAck; i < startAck + cwnd_ && i < packetCount_; ++i) {
         if (packetLost()) {
             lostAny_ = true;
         }
         else if (!lostAny_) {
             ++sw_.lastAck;
-            packets_[i].acked = true;
+            scoreboard_.setAcked(i);
         }
         else {
             break;
         }
     }
 
-    float estRtt = static_cast<float>(utils::randInt(20, 200)) + utils::randInt(1, 100) / 100;
-    if (mode_ == Mode::probeRtt) {
-        minRtt_ = std::min(minRtt_, estRtt);
-    }
-    else if (mode_ == Mode::probeBw) {
-        // float p = bandwidth_ * estRtt / minRtt_;
+    // The round model has no RTT to estimate. These two draws are where it used
+    // to draw one, and only keep the Philox stream, and so the loss traces of the
+    // results above, unchanged.
+    gen_();
+    gen_();
+    if (mode_ == Mode::probeBw) {
         bwInc_ = !bwInc_;
     }
 }
@@ -54,7 +54,6 @@ void Bbr::onRttUpdate() {
         if (probeCounter_ == 0) {
             probeCounter_ = minprobing::INTERVAL + minprobing::RTTS;
             mode_ = Mode::probeRtt;
-            minRtt_ = minprobing::BASE_RTT;
             saveCwnd_ = cwnd_;
         }
     }
@@ -83,3 +82,219 @@ void Bbr::onRttUpdate() {
     default:;
     }
 }
+
+// The event driven model is BBR v1: every ack updates the bandwidth and
+// propagation time estimates, then the mode decides the pacing and cwnd gains.
+bool Bbr::onAck(const AckEvent& ack) {
+    lastInflight_ = ack.inflight;
+    if (ack.acked == 0) return false;
+
+    updateRound(ack);
+    if (ack.deliveryRate > 0) {
+        maxBw_.update(roundCount_, ack.deliveryRate);
+    }
+    checkCyclePhase(ack);
+    checkFullPipe();
+    checkDrain(ack);
+    updateRtProp(ack);
+    checkProbeRtt(ack);
+    setPacingRate(ack);
+    setCwnd(ack);
+    if (roundStart_) {
+        lossInRound_ = false;
+    }
+    return false;
+}
+
+// Loss is not a congestion signal for BBR, the window only falls back to the
+// packets in flight during the first round of recovery (packet conservation)
+// and is restored once recovery ends.
+void Bbr::onLoss(LossEvent loss) {
+    lossInRound_ = true;
+    if (!recovery_) {
+        priorCwnd_ = cwnd_;
+    }
+    recovery_ = true;
+    recoveryRound_ = roundCount_;
+    if (loss == LossEvent::timeout) {
+        cwnd_ = 1;
+    }
+    else {
+        cwnd_ = std::max(lastInflight_, estimation::MIN_PIPE_CWND);
+    }
+}
+
+double Bbr::getPacingRate() const {
+    return pacingRate_;
+}
+
+bool Bbr::usesRateSamples() const {
+    return true;
+}
+
+Phase Bbr::getPhase() const {
+    switch (mode_) {
+    case Mode::startup: return Phase::startup;
+    case Mode::drain: return Phase::drain;
+    case Mode::probeBw: return Phase::probeBw;
+    default: return Phase::probeRtt;
+    }
+}
+
+double Bbr::getBdp(double gain) const {
+    if (maxBw_.empty() || rtProp_.empty()) {
+        return estimation::INITIAL_CWND;
+    }
+    return gain * maxBw_.get() * rtProp_.get() / NS_PER_SEC;
+}
+
+void Bbr::updateRound(const AckEvent& ack) {
+    roundStart_ = false;
+    if (ack.priorDelivered >= nextRoundDelivered_) {
+        nextRoundDelivered_ = ack.delivered;
+        ++roundCount_;
+        roundStart_ = true;
+    }
+}
+
+void Bbr::updateRtProp(const AckEvent& ack) {
+    rtPropExpired_ = ack.time > rtPropStamp_ + estimation::RTT_WINDOW;
+    if (ack.rtt < 0) return;
+    if (rtProp_.empty() || ack.rtt <= rtProp_.get() || rtPropExpired_) {
+        rtPropStamp_ = ack.time;
+    }
+    rtProp_.update(ack.time / (estimation::RTT_WINDOW / estimation::RTT_SLOTS), ack.rtt);
+}
+
+void Bbr::checkCyclePhase(const AckEvent& ack) {
+    if (mode_ != Mode::probeBw) return;
+
+    bool fullLength = rtProp_.empty() || ack.time - cycleStamp_ > rtProp_.get();
+    int priorInflight = ack.inflight + ack.acked;
+    bool next = fullLength;
+    if (pacingGain_ > 1.0) {
+        next = fullLength && (lossInRound_ || priorInflight >= getBdp(pacingGain_));
+    }
+    else if (pacingGain_ < 1.0) {
+        next = fullLength || priorInflight <= getBdp(1.0);
+    }
+    if (next) {
+        advanceCyclePhase(ack.time);
+    }
+}
+
+void Bbr::advanceCyclePhase(long long now) {
+    cycleStamp_ = now;
+    cycleIndex_ = (cycleIndex_ + 1) % gain::CYCLE_LENGTH;
+    pacingGain_ = gain::CYCLE[cycleIndex_];
+}
+
+// The pipe is full once three rounds in a row fail to grow the bandwidth by 25%.
+void Bbr::checkFullPipe() {
+    if (filledPipe_ || !roundStart_) return;
+    if (maxBw_.get() >= fullBw_ * estimation::FULL_BW_GROWTH) {
+        fullBw_ = maxBw_.get();
+        fullBwCount_ = 0;
+        return;
+    }
+    if (++fullBwCount_ >= estimation::FULL_BW_ROUNDS) {
+        filledPipe_ = true;
+    }
+}
+
+void Bbr::checkDrain(const AckEvent& ack) {
+    if (mode_ == Mode::startup && filledPipe_) {
+        mode_ = Mode::drain;
+        pacingGain_ = gain::DRAIN;
+        cwndGain_ = gain::HIGH;
+    }
+    if (mode_ == Mode::drain && ack.inflight <= getBdp(1.0)) {
+        enterProbeBw(ack.time);
+    }
+}
+
+void Bbr::checkProbeRtt(const AckEvent& ack) {
+    if (mode_ != Mode::probeRtt && rtPropExpired_) {
+        mode_ = Mode::probeRtt;
+        pacingGain_ = 1.0;
+        cwndGain_ = 1.0;
+        if (!recovery_) {
+            priorCwnd_ = cwnd_;
+        }
+        probeRttDone_ = -1;
+    }
+    if (mode_ != Mode::probeRtt) return;
+
+    if (probeRttDone_ < 0 && ack.inflight <= estimation::MIN_PIPE_CWND) {
+        probeRttDone_ = ack.time + estimation::PROBE_RTT_TIME;
+        probeRttRoundDone_ = false;
+        nextRoundDelivered_ = ack.delivered;
+    }
+    else if (probeRttDone_ >= 0) {
+        if (roundStart_) {
+            probeRttRoundDone_ = true;
+        }
+        if (probeRttRoundDone_ && ack.time > probeRttDone_) {
+            rtPropStamp_ = ack.time;
+            cwnd_ = std::max(cwnd_, priorCwnd_);
+            if (filledPipe_) {
+                enterProbeBw(ack.time);
+            }
+            else {
+                enterStartup();
+            }
+        }
+    }
+}
+
+void Bbr::enterStartup() {
+    mode_ = Mode::startup;
+    pacingGain_ = gain::HIGH;
+    cwndGain_ = gain::HIGH;
+}
+
+// Starts the gain cycle at a random phase other than the draining one.
+void Bbr::enterProbeBw(long long now) {
+    mode_ = Mode::probeBw;
+    cwndGain_ = gain::CWND;
+    cycleIndex_ = gain::CYCLE_LENGTH - 1 - utils::randInt(gen_, 0, gain::CYCLE_LENGTH - 2);
+    advanceCyclePhase(now);
+}
+
+void Bbr::setPacingRate(const AckEvent& ack) {
+    if (maxBw_.empty()) {
+        // Before the first rate sample the initial window is paced over the first rtt.
+        if (ack.rtt > 0) {
+            pacingRate_ = gain::HIGH * std::max(cwnd_, estimation::INITIAL_CWND) * NS_PER_SEC / ack.rtt;
+        }
+        return;
+    }
+    double rate = pacingGain_ * maxBw_.get();
+    if (filledPipe_ || rate > pacingRate_) {
+        pacingRate_ = rate;
+    }
+}
+
+void Bbr::setCwnd(const AckEvent& ack) {
+    if (recovery_ && !ack.partial && roundCount_ > recoveryRound_) {
+        recovery_ = false;
+        cwnd_ = std::max(cwnd_, priorCwnd_);
+    }
+
+    if (recovery_ && roundCount_ <= recoveryRound_ + 1) {
+        cwnd_ = std::max(cwnd_, ack.inflight + ack.acked);
+    }
+    else {
+        int target = static_cast<int>(getBdp(cwndGain_)) + 3;
+        if (filledPipe_) {
+            cwnd_ = std::min(cwnd_ + ack.acked, target);
+        }
+        else if (cwnd_ < target || ack.delivered < estimation::INITIAL_CWND) {
+            cwnd_ += ack.acked;
+        }
+        cwnd_ = std::max(cwnd_, estimation::MIN_PIPE_CWND);
+    }
+    if (mode_ == Mode::probeRtt) {
+        cwnd_ = std::min(cwnd_, estimation::MIN_PIPE_CWND);
+    }
+}
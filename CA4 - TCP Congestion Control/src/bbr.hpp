@@ -1,19 +1,46 @@
 #ifndef BBR_HPP_INCLUDE
 #define BBR_HPP_INCLUDE
 
+#include <functional>
+#include <limits>
+
 #include "tcp_connection.hpp"
+#include "windowed_filter.hpp"
 
 namespace minprobing {
 
 constexpr int INTERVAL = 20;
 constexpr int RTTS = 3;
 constexpr int CWND = 20;
-constexpr float BASE_RTT = 1000.0f;
 
 } // namespace minprobing
 
 constexpr float INITIAL_DRAINAGE = 0.2;
 
+// Parameters of the event driven model, from draft-cardwell-iccrg-bbr-congestion-control.
+namespace gain {
+
+constexpr double HIGH = 2.885; // 2/ln(2), doubles the delivery rate every round
+constexpr double DRAIN = 1 / HIGH;
+constexpr double CWND = 2.0;
+constexpr double CYCLE[] = {1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+constexpr int CYCLE_LENGTH = 8;
+
+} // namespace gain
+
+namespace estimation {
+
+constexpr int BW_ROUNDS = 10;
+constexpr int RTT_SLOTS = 10;
+constexpr long long RTT_WINDOW = 10 * NS_PER_SEC;
+constexpr long long PROBE_RTT_TIME = 200 * NS_PER_MS;
+constexpr int MIN_PIPE_CWND = 4;
+constexpr int INITIAL_CWND = 10;
+constexpr double FULL_BW_GROWTH = 1.25;
+constexpr int FULL_BW_ROUNDS = 3;
+
+} // namespace estimation
+
 class Bbr : public TcpConnection {
 public:
     enum class Mode {
@@ -29,6 +56,12 @@ public:
     bool onPacketLoss() override;
     void onRttUpdate() override;
 
+    bool onAck(const AckEvent& ack) override;
+    void onLoss(LossEvent loss) override;
+    double getPacingRate() const override;
+    bool usesRateSamples() const override;
+    Phase getPhase() const override;
+
 private:
     Mode mode_ = Mode::startup;
     bool lostAny_ = false;
@@ -37,8 +70,49 @@ private:
     bool bwInc_ = true;
     int saveCwnd_ = 1;
     int probeCounter_ = minprobing::INTERVAL - 1;
-    float minRtt_ = minprobing::BASE_RTT;
-    const float bandwidth_ = 1000.0f;
+
+    // Event driven model: bottleneck bandwidth in packets per second over the
+    // last rounds, and round trip propagation time in ns over the last seconds.
+    WindowedFilter<double, std::greater<double>, estimation::BW_ROUNDS> maxBw_{0.0};
+    WindowedFilter<long long, std::less<long long>, estimation::RTT_SLOTS> rtProp_{std::numeric_limits<long long>::max()};
+    long long rtPropStamp_ = 0;
+    bool rtPropExpired_ = false;
+
+    double pacingRate_ = 0.0;
+    double pacingGain_ = gain::HIGH;
+    double cwndGain_ = gain::HIGH;
+
+    long long roundCount_ = 0;
+    long long nextRoundDelivered_ = 0;
+    bool roundStart_ = false;
+
+    double fullBw_ = 0.0;
+    int fullBwCount_ = 0;
+    bool filledPipe_ = false;
+
+    int cycleIndex_ = 0;
+    long long cycleStamp_ = 0;
+    long long probeRttDone_ = -1;
+    bool probeRttRoundDone_ = false;
+
+    int priorCwnd_ = 0;
+    bool recovery_ = false;
+    long long recoveryRound_ = 0;
+    int lastInflight_ = 0;
+    bool lossInRound_ = false;
+
+    double getBdp(double gain) const;
+    void updateRound(const AckEvent& ack);
+    void updateRtProp(const AckEvent& ack);
+    void checkCyclePhase(const AckEvent& ack);
+    void advanceCyclePhase(long long now);
+    void checkFullPipe();
+    void checkDrain(const AckEvent& ack);
+    void checkProbeRtt(const AckEvent& ack);
+    void enterStartup();
+    void enterProbeBw(long long now);
+    void setPacingRate(const AckEvent& ack);
+    void setCwnd(const AckEvent& ack);
 };
 
 #endif // BBR_HPP_INCLUDE
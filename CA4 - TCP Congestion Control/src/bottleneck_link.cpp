@@ -0,0 +1,107 @@
+#include "bottleneck_link.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// RED draws from its own key, apart from the connection's generator and the loss models.
+constexpr uint64_t KEY_OFFSET = 0xD1B54A32D192ED03;
+
+} // namespace
+
+BottleneckLink::BottleneckLink(const Config& config, uint64_t seed, uint64_t stream)
+    : config_(config), gen_(seed + KEY_OFFSET, stream) {
+    config_.buffer = std::max(config_.buffer, 1);
+    double bits = config_.packetSize * 8.0;
+    transmissionTime_ = std::max<long long>(1, std::llround(bits * 1000.0 / config_.rate));
+    ring_.resize(config_.buffer);
+}
+
+const BottleneckLink::Config& BottleneckLink::getConfig() const {
+    return config_;
+}
+
+const BottleneckLink::Stats& BottleneckLink::getStats() const {
+    return stats_;
+}
+
+long long BottleneckLink::getTransmissionTime() const {
+    return transmissionTime_;
+}
+
+int BottleneckLink::getQueueLength() const {
+    return size_;
+}
+
+bool BottleneckLink::empty() const {
+    return size_ == 0;
+}
+
+bool BottleneckLink::enqueue(int flow, int seq, long long sentAt, long long now) {
+    if (config_.queue == Queue::red && redDrop(now)) {
+        ++stats_.redDrops;
+        return false;
+    }
+    if (size_ == config_.buffer) {
+        ++stats_.tailDrops;
+        return false;
+    }
+
+    int tail = head_ + size_;
+    if (tail >= config_.buffer) {
+        tail -= config_.buffer;
+    }
+    ring_[tail] = Packet{flow, seq, sentAt, now};
+    ++size_;
+    ++stats_.enqueued;
+    stats_.maxQueueLength = std::max(stats_.maxQueueLength, size_);
+    return true;
+}
+
+BottleneckLink::Packet BottleneckLink::dequeue(long long now) {
+    Packet packet = ring_[head_];
+    if (++head_ == config_.buffer) {
+        head_ = 0;
+    }
+    if (--size_ == 0) {
+        idleSince_ = now;
+    }
+
+    long long wait = now - transmissionTime_ - packet.enqueuedAt;
+    stats_.queueDelaySum += wait;
+    stats_.maxQueueDelay = std::max(stats_.maxQueueDelay, wait);
+    ++stats_.transmitted;
+    return packet;
+}
+
+// Random early detection as in Floyd & Jacobson: the average decays over idle
+// periods as if empty slots had arrived, and the drop probability grows with
+// the number of packets accepted since the last drop.
+bool BottleneckLink::redDrop(long long now) {
+    double weight = config_.redWeight;
+    if (size_ == 0) {
+        double slots = static_cast<double>(now - idleSince_) / transmissionTime_;
+        average_ *= std::pow(1.0 - weight, slots);
+    }
+    average_ = (1.0 - weight) * average_ + weight * size_;
+
+    if (average_ < config_.redMinThreshold) {
+        sinceDrop_ = -1;
+        return false;
+    }
+    if (average_ >= config_.redMaxThreshold) {
+        sinceDrop_ = 0;
+        return true;
+    }
+
+    ++sinceDrop_;
+    double range = config_.redMaxThreshold - config_.redMinThreshold;
+    double base = config_.redMaxProbability * (average_ - config_.redMinThreshold) / range;
+    double probability = sinceDrop_ * base >= 1.0 ? 1.0 : base / (1.0 - sinceDrop_ * base);
+    if (gen_.uniform() < probability) {
+        sinceDrop_ = 0;
+        return true;
+    }
+    return false;
+}
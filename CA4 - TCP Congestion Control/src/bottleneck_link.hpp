@@ -0,0 +1,80 @@
+#ifndef BOTTLENECK_LINK_HPP_INCLUDE
+#define BOTTLENECK_LINK_HPP_INCLUDE
+
+#include <cstdint>
+#include <vector>
+
+#include "philox.hpp"
+
+// Single FIFO link between the senders and the receivers. Packets that are not
+// dropped at the queue are transmitted one after another at the link rate and
+// reach the other side after the propagation delay.
+class BottleneckLink {
+public:
+    enum class Queue {
+        dropTail,
+        red,
+    };
+
+    struct Config {
+        double rate = 100.0;              // Mbps
+        long long delay = 20000000;       // one way propagation delay in ns
+        int buffer = 100;                 // packets, including the one in transmission
+        int packetSize = 1500;            // bytes
+        Queue queue = Queue::dropTail;
+        double redMinThreshold = 25.0;    // packets of average queue length
+        double redMaxThreshold = 75.0;
+        double redMaxProbability = 0.1;
+        double redWeight = 0.002;
+    };
+
+    struct Packet {
+        int flow;
+        int seq;
+        long long sentAt;
+        long long enqueuedAt;
+    };
+
+    struct Stats {
+        long long enqueued = 0;
+        long long transmitted = 0;
+        long long tailDrops = 0;
+        long long redDrops = 0;
+        long long queueDelaySum = 0;  // ns spent waiting behind other packets
+        long long maxQueueDelay = 0;
+        int maxQueueLength = 0;
+    };
+
+    BottleneckLink(const Config& config, uint64_t seed = 1, uint64_t stream = 0);
+
+    const Config& getConfig() const;
+    const Stats& getStats() const;
+    long long getTransmissionTime() const;
+    int getQueueLength() const;
+    bool empty() const;
+
+    // Returns false when the packet is dropped. A packet that finds the link
+    // idle starts its transmission right away and the caller has to schedule
+    // its departure after getTransmissionTime().
+    bool enqueue(int flow, int seq, long long sentAt, long long now);
+    // Removes the packet whose transmission ends at now.
+    Packet dequeue(long long now);
+
+private:
+    Config config_;
+    Stats stats_;
+    long long transmissionTime_;
+
+    std::vector<Packet> ring_;
+    int head_ = 0;
+    int size_ = 0;
+
+    double average_ = 0.0;
+    int sinceDrop_ = -1;
+    long long idleSince_ = 0;
+    Philox gen_;
+
+    bool redDrop(long long now);
+};
+
+#endif // BOTTLENECK_LINK_HPP_INCLUDE
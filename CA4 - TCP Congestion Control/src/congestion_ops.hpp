@@ -0,0 +1,112 @@
+#ifndef CONGESTION_OPS_HPP_INCLUDE
+#define CONGESTION_OPS_HPP_INCLUDE
+
+#include "tcp_connection.hpp"
+
+// Window a congestion control policy works on, in packets.
+struct Window {
+    int cwnd;
+    int ssthresh;
+};
+
+// Length of a round of the round model as seen by a policy.
+constexpr long long ROUND_TIME = 100 * NS_PER_MS;
+
+// Loss recovery of a PolicyConnection. Reno leaves recovery on the first new
+// ack, partial or not. New Reno retransmits the hole revealed by a partial ack
+// right away, and in the round model it keeps the packets acked after a loss
+// so that the next windows skip them.
+enum class Recovery {
+    reno,
+    newReno,
+};
+
+// A TcpConnection made of the shared transmission mechanics and a window policy.
+// Ops is a CongestionOps policy, a class with
+//
+//     bool onAck(Window& window, const AckEvent& ack);
+//     void onLoss(Window& window, LossEvent loss);
+//
+// with the meaning of the TcpConnection callbacks of the same names. The policy
+// is a member, so its calls are resolved at compile time. With New Reno
+// recovery, partial acks retransmit the next hole without reaching the policy,
+// so it sees one loss per window of data, and the full ack that ends recovery
+// brings the window down to the packets in flight (RFC 6582) instead of letting
+// a whole window leave in a burst. In the round model a round without losses is
+// one ack for the whole window, taking ROUND_TIME, and a lossy round reports a
+// triple duplicate ack or a timeout as Reno sees them. The window is not
+// inflated during a round, so the round after a fast retransmit ends recovery
+// and goes to the policy like any other.
+template <typename Ops, Recovery R = Recovery::newReno>
+class PolicyConnection : public TcpConnection {
+public:
+    using TcpConnection::TcpConnection;
+
+    void sendData() override {
+        int lastAck = sw_.lastAck;
+        sendWindow(R == Recovery::newReno);
+        ackedInRound_ = sw_.lastAck - lastAck;
+    }
+
+    bool onPacketLoss() override {
+        if (timeout_ != 0) {
+            --timeout_;
+            return true;
+        }
+        if (ackAfterLoss_ >= RETRANSMIT_ACKS) {
+            onLoss(LossEvent::tripleDupAck);
+            return true;
+        }
+        if (lostCount_ != 0) {
+            timeout_ = TIMEOUT_WAITTIME;
+            onLoss(LossEvent::timeout);
+            return true;
+        }
+        return false;
+    }
+
+    // Packets skipped because they were acked after a loss do not count twice.
+    void onRttUpdate() override {
+        if (ackedInRound_ == 0) return;
+        recovery_ = false;
+        long long delivered = sw_.lastAck + 1;
+        int acked = std::min(ackedInRound_, cwnd_);
+        onAck(AckEvent{(rtt_ + 1) * ROUND_TIME, ROUND_TIME, acked, cwnd_, delivered, false, -1.0, -1});
+    }
+
+    bool onAck(const AckEvent& ack) override {
+        if (recovery_ && ack.acked != 0) {
+            if (R == Recovery::newReno && ack.partial) return true;
+            recovery_ = false;
+            if (R == Recovery::newReno) {
+                cwnd_ = std::min(cwnd_, ack.inflight + 1);
+            }
+            return false;
+        }
+        Window window{cwnd_, ssthresh_};
+        bool retransmit = ops_.onAck(window, ack);
+        cwnd_ = std::max(window.cwnd, 1);
+        ssthresh_ = window.ssthresh;
+        return retransmit;
+    }
+
+    void onLoss(LossEvent loss) override {
+        recovery_ = loss == LossEvent::tripleDupAck;
+        Window window{cwnd_, ssthresh_};
+        ops_.onLoss(window, loss);
+        cwnd_ = std::max(window.cwnd, 1);
+        ssthresh_ = window.ssthresh;
+    }
+
+    Phase getPhase() const override {
+        if (recovery_ || timeout_ != 0) return Phase::recovery;
+        return TcpConnection::getPhase();
+    }
+
+private:
+    Ops ops_;
+    int ackedInRound_ = 0;
+    bool recovery_ = false;
+};
+
+#endif // CONGESTION_OPS_HPP_INCLUDE
@@ -0,0 +1,60 @@
+#include "cubic.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+bool Cubic::onAck(Window& window, const AckEvent& ack) {
+    if (ack.acked == 0) return false;
+    if (ack.rtt > 0 && (minRtt_ < 0 || ack.rtt < minRtt_)) {
+        minRtt_ = ack.rtt;
+    }
+
+    if (window.cwnd < window.ssthresh) {
+        window.cwnd = std::min(window.cwnd + ack.acked, window.ssthresh);
+        return false;
+    }
+    if (epochStart_ < 0) {
+        startEpoch(window, ack.time);
+    }
+
+    // Target one rtt ahead, and the window Reno would have with the same beta.
+    double rtt = static_cast<double>(std::max(minRtt_, 0LL)) / NS_PER_SEC;
+    double t = static_cast<double>(ack.time - epochStart_) / NS_PER_SEC + rtt;
+    double target = origin_ + C * std::pow(t - k_, 3);
+    wEst_ += 3 * (1 - BETA) / (1 + BETA) * ack.acked / window.cwnd;
+    target = std::max(target, wEst_);
+
+    // The window grows by (target - cwnd) / cwnd per acked packet, by at most
+    // half a packet.
+    double increment = std::clamp((target - window.cwnd) / window.cwnd, 0.0, 0.5);
+    ackedCount_ += increment * ack.acked;
+    if (ackedCount_ >= 1.0) {
+        window.cwnd += static_cast<int>(ackedCount_);
+        ackedCount_ -= std::floor(ackedCount_);
+    }
+    return false;
+}
+
+// Fast convergence: a flow losing before it got back to its last maximum
+// releases some bandwidth by remembering a lower one.
+void Cubic::onLoss(Window& window, LossEvent loss) {
+    double cwnd = window.cwnd;
+    wMax_ = cwnd < wMax_ ? cwnd * (1 + BETA) / 2 : cwnd;
+    epochStart_ = -1;
+    ackedCount_ = 0.0;
+    window.ssthresh = std::max(static_cast<int>(cwnd * BETA), 2);
+    window.cwnd = loss == LossEvent::timeout ? 1 : window.ssthresh;
+}
+
+void Cubic::startEpoch(const Window& window, long long now) {
+    epochStart_ = now;
+    wEst_ = window.cwnd;
+    if (window.cwnd < wMax_) {
+        k_ = std::cbrt((wMax_ - window.cwnd) / C);
+        origin_ = wMax_;
+    }
+    else {
+        k_ = 0.0;
+        origin_ = window.cwnd;
+    }
+}
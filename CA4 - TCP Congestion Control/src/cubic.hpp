@@ -0,0 +1,29 @@
+#ifndef CUBIC_HPP_INCLUDE
+#define CUBIC_HPP_INCLUDE
+
+#include "congestion_ops.hpp"
+
+// CUBIC as in RFC 9438: after a loss the window follows a cubic function of the
+// time since the loss, centered on the window at the loss, and never grows
+// slower than Reno would.
+class Cubic {
+public:
+    bool onAck(Window& window, const AckEvent& ack);
+    void onLoss(Window& window, LossEvent loss);
+
+private:
+    static constexpr double C = 0.4;
+    static constexpr double BETA = 0.7;
+
+    double wMax_ = 0.0;
+    double wEst_ = 0.0;
+    double k_ = 0.0;       // seconds from the start of the epoch to wMax_
+    double origin_ = 0.0;
+    long long epochStart_ = -1;
+    long long minRtt_ = -1;
+    double ackedCount_ = 0.0;
+
+    void startEpoch(const Window& window, long long now);
+};
+
+#endif // CUBIC_HPP_INCLUDE
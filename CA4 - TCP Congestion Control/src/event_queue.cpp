@@ -0,0 +1,43 @@
+#include "event_queue.hpp"
+
+void EventQueue::push(long long time, Event::Type type, int flow, int seq, long long stamp, int trigger) {
+    Event event{time, order_++, stamp, type, flow, seq, trigger};
+    size_t hole = heap_.size();
+    heap_.push_back(event);
+    while (hole != 0) {
+        size_t parent = (hole - 1) / 2;
+        if (!before(event, heap_[parent])) break;
+        heap_[hole] = heap_[parent];
+        hole = parent;
+    }
+    heap_[hole] = event;
+}
+
+Event EventQueue::pop() {
+    Event result = heap_.front();
+    Event last = heap_.back();
+    heap_.pop_back();
+    size_t size = heap_.size();
+    if (size == 0) {
+        return result;
+    }
+
+    size_t hole = 0;
+    while (true) {
+        size_t child = 2 * hole + 1;
+        if (child >= size) break;
+        if (child + 1 < size && before(heap_[child + 1], heap_[child])) {
+            ++child;
+        }
+        if (!before(heap_[child], last)) break;
+        heap_[hole] = heap_[child];
+        hole = child;
+    }
+    heap_[hole] = last;
+    return result;
+}
+
+void EventQueue::clear() {
+    heap_.clear();
+    order_ = 0;
+}
@@ -0,0 +1,47 @@
+#ifndef EVENT_QUEUE_HPP_INCLUDE
+#define EVENT_QUEUE_HPP_INCLUDE
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Event {
+    enum class Type : uint8_t {
+        departure, // the head of the bottleneck queue is fully transmitted
+        ack,       // an ack reaches its sender
+        timeout,   // retransmission timer of a flow, may be stale
+        start,     // a flow sends its first window
+        send,      // the pacing gap of a flow is over
+        arrival,   // a packet delayed by the channel reaches the receiver
+    };
+
+    long long time; // ns
+    uint64_t order; // insertion order, breaks ties so runs are deterministic
+    long long stamp;
+    Type type;
+    int flow;
+    int seq;
+    int trigger;    // packet that caused an ack
+};
+
+// Binary min-heap of events ordered by time then insertion.
+class EventQueue {
+public:
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+    const Event& top() const { return heap_.front(); }
+
+    void push(long long time, Event::Type type, int flow, int seq = 0, long long stamp = 0, int trigger = 0);
+    Event pop();
+    void clear();
+
+private:
+    std::vector<Event> heap_;
+    uint64_t order_ = 0;
+
+    static bool before(const Event& a, const Event& b) {
+        return a.time < b.time || (a.time == b.time && a.order < b.order);
+    }
+};
+
+#endif // EVENT_QUEUE_HPP_INCLUDE
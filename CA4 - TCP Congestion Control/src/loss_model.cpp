@@ -0,0 +1,166 @@
+#include "loss_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace loss {
+
+namespace {
+
+// The models draw from their own key, apart from the connection's generator.
+constexpr uint64_t KEY_OFFSET = 0x9E3779B97F4A7C15;
+
+uint64_t toThreshold(double probability) {
+    return static_cast<uint64_t>(std::llround(probability * 4294967296.0));
+}
+
+bool validProbability(double probability) {
+    return probability >= 0.0 && probability <= 1.0;
+}
+
+// A Gilbert-Elliott channel delivers nothing once it stays in a state that
+// loses every packet: the good state unless it always leaves it, the bad one if
+// it never leaves it, or both.
+bool delivers(double p, double r, double lossBad, double lossGood) {
+    if (lossGood == 1.0 && (p < 1.0 || lossBad == 1.0)) return false;
+    return !(lossBad == 1.0 && p > 0.0 && r == 0.0);
+}
+
+std::vector<std::string> splitSpec(const std::string& spec) {
+    std::vector<std::string> parts;
+    std::istringstream ss(spec);
+    std::string part;
+    while (std::getline(ss, part, ':')) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+} // namespace
+
+void Model::startRound(int) {}
+
+Bernoulli::Bernoulli(double probability, uint64_t seed, uint64_t stream)
+    : threshold_(toThreshold(probability)), gen_(seed + KEY_OFFSET, stream), draws_(BATCH) {}
+
+void Bernoulli::refill() {
+    gen_.fill(draws_.data(), BATCH);
+    lost_.resize(BATCH);
+    for (size_t i = 0; i < BATCH; ++i) {
+        lost_[i] = draws_[i] < threshold_;
+    }
+}
+
+GilbertElliott::GilbertElliott(double p, double r, double lossBad, double lossGood, uint64_t seed, uint64_t stream)
+    : toBad_(toThreshold(p)), toGood_(toThreshold(r)),
+      lossBad_(toThreshold(lossBad)), lossGood_(toThreshold(lossGood)),
+      gen_(seed + KEY_OFFSET, stream), draws_(2 * BATCH) {}
+
+void GilbertElliott::refill() {
+    gen_.fill(draws_.data(), 2 * BATCH);
+    lost_.resize(BATCH);
+    for (size_t i = 0; i < BATCH; ++i) {
+        lost_[i] = draws_[2 * i] < (bad_ ? lossBad_ : lossGood_);
+        bad_ = bad_ ? draws_[2 * i + 1] >= toGood_ : draws_[2 * i + 1] < toBad_;
+    }
+}
+
+Overflow::Overflow(double bdp, int buffer)
+    : bdp_(bdp), buffer_(buffer) {}
+
+void Overflow::startRound(int cwnd) {
+    lost_.assign(cwnd, 0);
+    position_ = 0;
+    if (cwnd <= bdp_ + buffer_) return;
+
+    // Every arrival adds one packet to the queue and the link takes bdp/cwnd.
+    double drain = bdp_ / cwnd;
+    double queue = 0.0;
+    for (int i = 0; i < cwnd; ++i) {
+        queue = std::max(queue - drain, 0.0) + 1.0;
+        if (queue > buffer_) {
+            lost_[i] = 1;
+            queue -= 1.0;
+        }
+    }
+}
+
+void Overflow::refill() {
+    lost_.assign(BATCH, 0);
+}
+
+std::unique_ptr<Replay> Replay::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) return nullptr;
+
+    auto replay = std::make_unique<Replay>();
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream ss(line);
+        int lost;
+        if (line.empty() || line[0] == '#' || !(ss >> lost)) continue;
+        double delay = 0.0;
+        if (ss >> delay) {
+            replay->hasDelays_ = true;
+        }
+        replay->traceLost_.push_back(lost != 0);
+        replay->traceDelays_.push_back(std::llround(delay * 1e6));
+    }
+    auto& lost = replay->traceLost_;
+    if (std::find(lost.begin(), lost.end(), 0) == lost.end()) return nullptr;
+    return replay;
+}
+
+void Replay::refill() {
+    lost_.resize(BATCH);
+    if (hasDelays_) {
+        delays_.resize(BATCH);
+    }
+    for (size_t i = 0; i < BATCH; ++i) {
+        lost_[i] = traceLost_[offset_];
+        if (hasDelays_) {
+            delays_[i] = traceDelays_[offset_];
+        }
+        if (++offset_ == traceLost_.size()) {
+            offset_ = 0;
+        }
+    }
+}
+
+std::unique_ptr<Model> make(const std::string& spec, const BottleneckLink::Config& link,
+                            uint64_t seed, uint64_t stream) {
+    if (spec.rfind("trace:", 0) == 0) {
+        return Replay::load(spec.substr(6));
+    }
+    std::vector<std::string> parts = splitSpec(spec);
+    if (parts.empty()) return nullptr;
+    try {
+        if (parts[0] == "bernoulli" && parts.size() == 2) {
+            double p = std::stod(parts[1]);
+            if (!validProbability(p) || p == 1.0) return nullptr;
+            return std::make_unique<Bernoulli>(p, seed, stream);
+        }
+        if (parts[0] == "ge" && parts.size() >= 3 && parts.size() <= 5) {
+            double values[4] = {0.0, 0.0, 1.0, 0.0};
+            for (size_t i = 1; i < parts.size(); ++i) {
+                values[i - 1] = std::stod(parts[i]);
+                if (!validProbability(values[i - 1])) return nullptr;
+            }
+            if (!delivers(values[0], values[1], values[2], values[3])) return nullptr;
+            return std::make_unique<GilbertElliott>(values[0], values[1], values[2], values[3], seed, stream);
+        }
+        if (parts[0] == "overflow" && parts.size() == 1) {
+            double rtt = 2.0 * link.delay / 1e9;
+            double bdp = link.rate * 1e6 * rtt / (link.packetSize * 8.0);
+            return std::make_unique<Overflow>(bdp, link.buffer);
+        }
+    }
+    catch (const std::exception&) {
+        return nullptr;
+    }
+    return nullptr;
+}
+
+} // namespace loss
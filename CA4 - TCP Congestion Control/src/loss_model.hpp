@@ -0,0 +1,127 @@
+#ifndef LOSS_MODEL_HPP_INCLUDE
+#define LOSS_MODEL_HPP_INCLUDE
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bottleneck_link.hpp"
+#include "philox.hpp"
+
+namespace loss {
+
+// Decides packet by packet which packets are lost, and the extra one way delay
+// of the others. The decisions are made BATCH packets at a time, so that the
+// per packet call only reads the next one.
+class Model {
+public:
+    virtual ~Model() = default;
+
+    // Called before every window of the round model.
+    virtual void startRound(int cwnd);
+
+    bool next() {
+        if (position_ == lost_.size()) {
+            refill();
+            position_ = 0;
+        }
+        current_ = position_++;
+        return lost_[current_] != 0;
+    }
+
+    // ns of extra delay of the packet of the last next().
+    long long getDelay() const {
+        return delays_.empty() ? 0 : delays_[current_];
+    }
+
+protected:
+    static constexpr size_t BATCH = 1024;
+
+    std::vector<uint8_t> lost_;
+    std::vector<long long> delays_; // empty for the models without delay
+    size_t position_ = 0;
+    size_t current_ = 0;
+
+    virtual void refill() = 0;
+};
+
+// Every packet is lost with the same probability.
+class Bernoulli : public Model {
+public:
+    Bernoulli(double probability, uint64_t seed, uint64_t stream);
+
+protected:
+    void refill() override;
+
+private:
+    uint64_t threshold_; // of a 32 bit draw
+    Philox gen_;
+    std::vector<uint32_t> draws_;
+};
+
+// Two state Markov chain of bursty loss: the channel goes from the good to the
+// bad state with probability p and back with probability r after every packet,
+// and loses packets with the loss probability of its state.
+class GilbertElliott : public Model {
+public:
+    GilbertElliott(double p, double r, double lossBad, double lossGood, uint64_t seed, uint64_t stream);
+
+protected:
+    void refill() override;
+
+private:
+    uint64_t toBad_;
+    uint64_t toGood_;
+    uint64_t lossBad_;
+    uint64_t lossGood_;
+    bool bad_ = false;
+    Philox gen_;
+    std::vector<uint32_t> draws_;
+};
+
+// Fluid model of a drop-tail bottleneck for the round model: the window arrives
+// evenly over the round while the link carries bdp packets, and the arrivals
+// that find the buffer full are lost.
+class Overflow : public Model {
+public:
+    Overflow(double bdp, int buffer);
+
+    void startRound(int cwnd) override;
+
+protected:
+    void refill() override;
+
+private:
+    double bdp_;
+    int buffer_;
+};
+
+// Replays a recorded trace, one packet per line: 1 or 0 for lost or not and
+// optionally the extra delay in ms. Lines starting with # are comments. The
+// trace starts over when it ends.
+class Replay : public Model {
+public:
+    // Empty when the file cannot be read or every packet of it is lost.
+    static std::unique_ptr<Replay> load(const std::string& path);
+
+protected:
+    void refill() override;
+
+private:
+    std::vector<uint8_t> traceLost_;
+    std::vector<long long> traceDelays_;
+    bool hasDelays_ = false;
+    size_t offset_ = 0;
+};
+
+// Models by name: bernoulli:<p>, ge:<p>:<r>[:<loss bad>[:<loss good>]],
+// overflow (from the link's rate, delay and buffer) and trace:<file>. Returns
+// nullptr for an invalid spec, and for the models that can never deliver a
+// packet: a loss probability of 1, or a trace without delivered packets.
+std::unique_ptr<Model> make(const std::string& spec, const BottleneckLink::Config& link,
+                            uint64_t seed, uint64_t stream = 0);
+
+} // namespace loss
+
+#endif // LOSS_MODEL_HPP_INCLUDE
@@ -1,16 +1,386 @@
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
 
-#include "bbr.hpp"
-#include "new_reno.hpp"
-#include "reno.hpp"
+#include "algorithms.hpp"
+#include "loss_model.hpp"
+#include "scenario.hpp"
+#include "simulator.hpp"
+#include "sweep.hpp"
+#include "trace.hpp"
 
-int main() {
-    std::vector<int> data(100000);
-    for (unsigned i = 0; i < data.size(); ++i) {
-        data[i] = i;
+namespace {
+
+const std::string USAGE =
+    "Usage: tcp.out [rounds|events] [<algorithm>] [--packets=<n>] [--cwnd=<n>] [--ssthresh=<n>]\n"
+    "               [--loss=<model>] [--trace=<file>] [--stats]\n"
+    "               [--rate=<Mbps>] [--delay=<ms>] [--buffer=<packets>] [--queue=droptail|red] [--seed=<n>]\n"
+    "       tcp.out flows --flows=<algorithm>:<n>[,...] [--duration=<s>] [--rtt-spread=<ms>] [--start-spread=<ms>]\n"
+    "               [--per-flow] [<events options>]\n"
+    "       tcp.out sweep [--algorithms=<a>,...] [--cwnds=<n>,...] [--ssthresholds=<n|inf>,...]\n"
+    "               [--losses=exp|droptail|red|<model>,...] [--seeds=<n>] [--threads=<n>] [<events options>]\n"
+    "       tcp.out convert --trace=<file>\n"
+    "Loss models: bernoulli:<p> ge:<p>:<r>[:<loss bad>[:<loss good>]] overflow trace:<file>";
+
+struct Options {
+    std::string command = "rounds";
+    std::string algorithm = "reno";
+    int packets = 100000;
+    int cwnd = 1;
+    int ssthresh = std::numeric_limits<int>::max();
+    uint64_t seed = 1;
+    BottleneckLink::Config link;
+    std::string loss;
+
+    std::string trace;
+    bool stats = false;
+
+    std::vector<scenario::FlowGroup> groups;
+    long long duration = -1;
+    long long rttSpread = 0;
+    long long startSpread = 0;
+    bool perFlow = false;
+
+    sweep::Options sweep;
+};
+
+bool parseValue(const std::string& arg, const std::string& name, std::string& value) {
+    if (arg.rfind(name, 0) != 0) return false;
+    value = arg.substr(name.size());
+    return true;
+}
+
+long long parseMs(const std::string& value) {
+    return std::llround(std::stod(value) * NS_PER_MS);
+}
+
+bool parseGroups(const std::string& value, std::vector<scenario::FlowGroup>& groups) {
+    std::istringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t colon = item.find(':');
+        scenario::FlowGroup group{item.substr(0, colon), 1};
+        if (colon != std::string::npos) {
+            group.count = std::stoi(item.substr(colon + 1));
+        }
+        if (!algorithms::exists(group.algorithm) || group.count < 1) return false;
+        groups.push_back(group);
+    }
+    return !groups.empty();
+}
+
+std::vector<std::string> split(const std::string& value) {
+    std::vector<std::string> items;
+    std::istringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+bool parseInts(const std::string& value, std::vector<int>& ints) {
+    ints.clear();
+    for (auto& item : split(value)) {
+        int n = item == "inf" ? std::numeric_limits<int>::max() : std::stoi(item);
+        if (n < 1) return false;
+        ints.push_back(n);
+    }
+    return !ints.empty();
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    bool algorithmSet = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value;
+        try {
+            if (i == 1 && (arg == "rounds" || arg == "events" || arg == "flows" || arg == "sweep" || arg == "convert")) {
+                options.command = arg;
+            }
+            else if (!algorithmSet && algorithms::exists(arg)) {
+                options.algorithm = arg;
+                algorithmSet = true;
+            }
+            else if (parseValue(arg, "--packets=", value)) {
+                options.packets = std::stoi(value);
+            }
+            else if (parseValue(arg, "--cwnd=", value)) {
+                options.cwnd = std::stoi(value);
+            }
+            else if (parseValue(arg, "--ssthresh=", value)) {
+                options.ssthresh = std::stoi(value);
+            }
+            else if (parseValue(arg, "--rate=", value)) {
+                options.link.rate = std::stod(value);
+            }
+            else if (parseValue(arg, "--delay=", value)) {
+                options.link.delay = parseMs(value);
+            }
+            else if (parseValue(arg, "--buffer=", value)) {
+                options.link.buffer = std::stoi(value);
+            }
+            else if (arg == "--queue=droptail") {
+                options.link.queue = BottleneckLink::Queue::dropTail;
+            }
+            else if (arg == "--queue=red") {
+                options.link.queue = BottleneckLink::Queue::red;
+            }
+            else if (parseValue(arg, "--seed=", value)) {
+                options.seed = std::stoull(value);
+            }
+            else if (parseValue(arg, "--flows=", value)) {
+                if (!parseGroups(value, options.groups)) return false;
+            }
+            else if (parseValue(arg, "--duration=", value)) {
+                options.duration = std::llround(std::stod(value) * NS_PER_SEC);
+            }
+            else if (parseValue(arg, "--rtt-spread=", value)) {
+                options.rttSpread = parseMs(value);
+            }
+            else if (parseValue(arg, "--start-spread=", value)) {
+                options.startSpread = parseMs(value);
+            }
+            else if (parseValue(arg, "--loss=", value)) {
+                if (!loss::make(value, options.link, options.seed)) return false;
+                options.loss = value;
+            }
+            else if (parseValue(arg, "--trace=", value)) {
+                options.trace = value;
+            }
+            else if (arg == "--stats") {
+                options.stats = true;
+            }
+            else if (arg == "--per-flow") {
+                options.perFlow = true;
+            }
+            else if (parseValue(arg, "--algorithms=", value)) {
+                options.sweep.algorithms = split(value);
+                for (auto& name : options.sweep.algorithms) {
+                    if (!algorithms::exists(name)) return false;
+                }
+                if (options.sweep.algorithms.empty()) return false;
+            }
+            else if (parseValue(arg, "--cwnds=", value)) {
+                if (!parseInts(value, options.sweep.cwnds)) return false;
+            }
+            else if (parseValue(arg, "--ssthresholds=", value)) {
+                if (!parseInts(value, options.sweep.ssthresholds)) return false;
+            }
+            else if (parseValue(arg, "--losses=", value)) {
+                options.sweep.losses = split(value);
+                for (auto& name : options.sweep.losses) {
+                    if (!sweep::validLossModel(name)) return false;
+                }
+                if (options.sweep.losses.empty()) return false;
+            }
+            else if (parseValue(arg, "--seeds=", value)) {
+                options.sweep.seeds = std::stoi(value);
+            }
+            else if (parseValue(arg, "--threads=", value)) {
+                options.sweep.threads = std::stoi(value);
+            }
+            else {
+                return false;
+            }
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+    }
+    if (options.packets < 0 || options.cwnd < 1 || options.ssthresh < 1 ||
+        options.link.rate <= 0 || options.link.delay < 0 || options.link.buffer < 1 ||
+        options.rttSpread < 0 || options.startSpread < 0 ||
+        options.sweep.seeds < 1 || options.sweep.threads < 0 ||
+        (options.command == "flows") != !options.groups.empty() ||
+        (options.command == "convert" && options.trace.empty()) ||
+        (options.loss == "overflow" && options.command != "rounds")) {
+        return false;
+    }
+    options.link.redMinThreshold = options.link.buffer / 4.0;
+    options.link.redMaxThreshold = options.link.buffer * 3 / 4.0;
+    return true;
+}
+
+void printSummary(const Simulator::Report& report, double seconds) {
+    std::cout << std::fixed << std::setprecision(3)
+              << "packets: " << report.delivered << '\n'
+              << "duration: " << static_cast<double>(report.duration) / NS_PER_SEC << " s\n"
+              << "throughput: " << report.throughput << " Mbps\n"
+              << "utilization: " << report.utilization * 100 << " %\n"
+              << "queueing delay: mean " << report.meanQueueDelay << " ms, max " << report.maxQueueDelay << " ms\n"
+              << "sent: " << report.sent << ", retransmits: " << report.retransmits
+              << ", fast retransmits: " << report.fastRetransmits << ", timeouts: " << report.timeouts << '\n';
+    if (report.abandoned != 0) {
+        std::cout << "abandoned: " << report.abandoned << " flows after " << Simulator::MAX_RETRIES << " timeouts in a row\n";
+    }
+    std::cout << "drops: " << report.link.tailDrops + report.link.redDrops + report.channelDrops
+              << " (tail " << report.link.tailDrops << ", red " << report.link.redDrops
+              << ", channel " << report.channelDrops << ")\n"
+              << "events: " << report.events << " in " << seconds << " s ("
+              << (seconds > 0 ? report.events / seconds / 1e6 : 0.0) << " M/s)\n";
+}
+
+void printScenario(const scenario::Report& report, bool perFlow) {
+    std::cout << "fairness: " << report.fairness << '\n'
+              << "algorithm,flows,goodput,fairness,rtt_inflation,loss_share\n";
+    for (auto& group : report.groups) {
+        std::cout << group.algorithm << ',' << group.flows << ',' << group.goodput << ','
+                  << group.fairness << ',' << group.rttInflation << ',' << group.lossShare << '\n';
+    }
+    if (!perFlow) return;
+
+    std::cout << "flow,algorithm,goodput,mean_rtt,base_rtt,drops,retransmits,timeouts,finished\n";
+    const auto& flows = report.simulation.flows;
+    for (size_t i = 0; i < flows.size(); ++i) {
+        const auto& flow = flows[i];
+        std::cout << i << ',' << report.algorithms[i] << ',' << flow.goodput << ','
+                  << flow.meanRtt << ',' << flow.baseRtt << ',' << flow.drops << ','
+                  << flow.retransmits << ',' << flow.timeouts << ','
+                  << (flow.finishedAt >= 0 ? static_cast<double>(flow.finishedAt) / NS_PER_SEC : -1.0) << '\n';
+    }
+}
+
+void warnIfStalled(const RoundStats& stats) {
+    if (stats.stalled) {
+        std::cerr << "gave up after " << MAX_STALLED_ROUNDS << " rounds without a new ack" << std::endl;
+    }
+}
+
+// Passes the rounds on to both sinks.
+class TraceTee : public trace::Sink {
+public:
+    TraceTee(trace::Sink& first, trace::Sink& second)
+        : first_(first), second_(second) {}
+
+    void write(const trace::Record& record) override {
+        first_.write(record);
+        second_.write(record);
     }
 
-    Reno reno(data);
-    reno.run(std::cout);
+private:
+    trace::Sink& first_;
+    trace::Sink& second_;
+};
+
+int runRounds(TcpConnection& connection, const Options& options) {
+    if (options.trace.empty() && !options.stats) {
+        warnIfStalled(connection.run(std::cout));
+        return 0;
+    }
+
+    std::unique_ptr<trace::Writer> writer;
+    if (!options.trace.empty()) {
+        writer = std::make_unique<trace::Writer>(options.trace);
+        if (!writer->good()) {
+            std::cerr << "cannot write " << options.trace << std::endl;
+            return 1;
+        }
+    }
+    trace::Stats stats;
+    trace::Sink* sink = &stats;
+    std::unique_ptr<TraceTee> tee;
+    if (writer) {
+        sink = writer.get();
+        if (options.stats) {
+            tee = std::make_unique<TraceTee>(*writer, stats);
+            sink = tee.get();
+        }
+    }
+
+    warnIfStalled(connection.runRounds(nullptr, sink));
+    if (writer) {
+        writer->flush();
+        if (!writer->good()) {
+            std::cerr << "cannot write " << options.trace << std::endl;
+            return 1;
+        }
+    }
+    if (options.stats) {
+        stats.print(std::cout);
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << USAGE << "\nAlgorithms:";
+        for (auto& name : algorithms::names()) {
+            std::cerr << ' ' << name;
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+
+    if (options.command == "convert") {
+        std::ifstream file(options.trace, std::ios::binary);
+        if (!trace::writeCsv(file, std::cout)) {
+            std::cerr << options.trace << " is not a trace" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (options.command == "sweep") {
+        options.sweep.packets = options.packets;
+        options.sweep.seed = options.seed;
+        options.sweep.link = options.link;
+        auto summaries = sweep::run(options.sweep);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        sweep::writeCsv(std::cout, summaries);
+        std::cerr << summaries.size() * options.sweep.seeds << " runs in " << elapsed.count() << " s" << std::endl;
+        return 0;
+    }
+    if (options.command == "flows") {
+        scenario::Options scenarioOptions;
+        scenarioOptions.groups = options.groups;
+        scenarioOptions.packets = options.packets;
+        scenarioOptions.cwnd = options.cwnd;
+        scenarioOptions.ssthresh = options.ssthresh;
+        scenarioOptions.rttSpread = options.rttSpread;
+        scenarioOptions.startSpread = options.startSpread;
+        scenarioOptions.duration = options.duration;
+        scenarioOptions.link = options.link;
+        scenarioOptions.loss = options.loss;
+        scenarioOptions.seed = options.seed;
+        scenario::Report report = scenario::run(scenarioOptions);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "flows: " << report.algorithms.size() << '\n';
+        printSummary(report.simulation, elapsed.count());
+        printScenario(report, options.perFlow);
+        return 0;
+    }
+
+    auto connection = algorithms::make(options.algorithm, options.packets, options.cwnd, options.ssthresh);
+    connection->setSeed(options.seed);
+
+    if (options.command == "rounds") {
+        if (!options.loss.empty()) {
+            connection->setLossModel(loss::make(options.loss, options.link, options.seed));
+        }
+        return runRounds(*connection, options);
+    }
+
+    Simulator simulator(options.link, options.seed);
+    std::unique_ptr<loss::Model> channel;
+    if (!options.loss.empty()) {
+        channel = loss::make(options.loss, options.link, options.seed);
+        simulator.setChannel(channel.get());
+    }
+    simulator.addFlow(*connection);
+    Simulator::Report report = simulator.run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "algorithm: " << options.algorithm << '\n';
+    printSummary(report, elapsed.count());
     return 0;
 }
@@ -3,11 +3,7 @@
 
 #include "reno.hpp"
 
-class NewReno : public Reno {
-public:
-    using Reno::Reno;
-
-    void sendData() override;
-};
+// The window policy of Reno with New Reno's loss recovery.
+using NewReno = PolicyConnection<Aimd, Recovery::newReno>;
 
 #endif // NEW_RENO_HPP_INCLUDE
@@ -0,0 +1,114 @@
+#ifndef PHILOX_HPP_INCLUDE
+#define PHILOX_HPP_INCLUDE
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Philox4x32-10 counter based generator (Salmon et al., Random123). The output
+// is a pure function of the key (seed), the stream and the position, so every
+// run of a sweep gets its own independent sequence without shared state.
+class Philox {
+public:
+    using result_type = uint32_t;
+
+    explicit Philox(uint64_t seed = 0, uint64_t stream = 0) { reset(seed, stream); }
+
+    void reset(uint64_t seed, uint64_t stream = 0) {
+        key_[0] = static_cast<uint32_t>(seed);
+        key_[1] = static_cast<uint32_t>(seed >> 32);
+        counter_[0] = 0;
+        counter_[1] = 0;
+        counter_[2] = static_cast<uint32_t>(stream);
+        counter_[3] = static_cast<uint32_t>(stream >> 32);
+        index_ = 4;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        if (index_ == 4) {
+            generate();
+            index_ = 0;
+        }
+        return block_[index_++];
+    }
+
+    // Same values as n calls, generated a block at a time.
+    void fill(result_type* out, size_t n) {
+        size_t i = 0;
+        while (i < n && index_ < 4) {
+            out[i++] = block_[index_++];
+        }
+        while (n - i >= 4) {
+            generate();
+            out[i] = block_[0];
+            out[i + 1] = block_[1];
+            out[i + 2] = block_[2];
+            out[i + 3] = block_[3];
+            i += 4;
+        }
+        if (i < n) {
+            generate();
+            index_ = 0;
+            while (i < n) {
+                out[i++] = block_[index_++];
+            }
+        }
+    }
+
+    // Uniform in [0, 1).
+    double uniform() {
+        return (*this)() * (1.0 / 4294967296.0);
+    }
+
+    // Uniform in [first, last] by multiply-shift, the bias is below 2^-32 * range.
+    int uniformInt(int first, int last) {
+        uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(last) - first) + 1;
+        return first + static_cast<int>((static_cast<uint64_t>((*this)()) * range) >> 32);
+    }
+
+private:
+    uint32_t key_[2];
+    uint32_t counter_[4];
+    uint32_t block_[4];
+    int index_;
+
+    void generate() {
+        constexpr uint64_t M0 = 0xD2511F53;
+        constexpr uint64_t M1 = 0xCD9E8D57;
+        constexpr uint32_t W0 = 0x9E3779B9;
+        constexpr uint32_t W1 = 0xBB67AE85;
+
+        uint32_t c[4] = {counter_[0], counter_[1], counter_[2], counter_[3]};
+        uint32_t k0 = key_[0];
+        uint32_t k1 = key_[1];
+        for (int round = 0; round < 10; ++round) {
+            uint64_t p0 = M0 * c[0];
+            uint64_t p1 = M1 * c[2];
+            uint32_t next[4] = {
+                static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k0,
+                static_cast<uint32_t>(p1),
+                static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k1,
+                static_cast<uint32_t>(p0),
+            };
+            c[0] = next[0];
+            c[1] = next[1];
+            c[2] = next[2];
+            c[3] = next[3];
+            k0 += W0;
+            k1 += W1;
+        }
+        block_[0] = c[0];
+        block_[1] = c[1];
+        block_[2] = c[2];
+        block_[3] = c[3];
+
+        if (++counter_[0] == 0) {
+            ++counter_[1];
+        }
+    }
+};
+
+#endif // PHILOX_HPP_INCLUDE
@@ -1,30 +1,20 @@
 #ifndef RENO_HPP_INCLUDE
 #define RENO_HPP_INCLUDE
 
-#include "tcp_connection.hpp"
+#include "congestion_ops.hpp"
 
-constexpr int RETRANSMIT_ACKS = 3;
-
-class Reno : public TcpConnection {
+// Additive increase, multiplicative decrease: slow start grows the window by
+// the acked packets up to ssthresh, congestion avoidance by one packet per
+// window of acks, and a loss halves it (down to one packet on a timeout).
+class Aimd {
 public:
-    enum class Mode {
-        addIncMultDec,
-        slowStart,
-        fastRetransmit
-    };
-
-    using TcpConnection::TcpConnection;
-
-    void sendData() override;
-    bool onPacketLoss() override;
-    void onRttUpdate() override;
+    bool onAck(Window& window, const AckEvent& ack);
+    void onLoss(Window& window, LossEvent loss);
 
-protected:
-    Mode mode_ = Mode::slowStart;
-    const bool fastRecovery_ = true;
-
-    int lostCount_ = 0;
-    int ackAfterLoss_ = 0;
+private:
+    int ackedInWindow_ = 0;
 };
 
+using Reno = PolicyConnection<Aimd, Recovery::reno>;
+
 #endif // RENO_HPP_INCLUDE
@@ -0,0 +1,87 @@
+#include "scenario.hpp"
+
+#include <memory>
+
+#include "algorithms.hpp"
+#include "loss_model.hpp"
+
+namespace scenario {
+
+double jainIndex(const std::vector<double>& values) {
+    double sum = 0.0;
+    double squares = 0.0;
+    for (double value : values) {
+        sum += value;
+        squares += value * value;
+    }
+    if (squares == 0.0) return 1.0;
+    return sum * sum / (values.size() * squares);
+}
+
+Report run(const Options& options) {
+    Report report;
+    std::vector<std::unique_ptr<TcpConnection>> connections;
+    for (auto& group : options.groups) {
+        for (int i = 0; i < group.count; ++i) {
+            connections.push_back(algorithms::make(group.algorithm, options.packets, options.cwnd, options.ssthresh));
+            connections.back()->setSeed(options.seed, connections.size() - 1);
+            report.algorithms.push_back(group.algorithm);
+        }
+    }
+
+    Simulator simulator(options.link, options.seed);
+    std::unique_ptr<loss::Model> channel;
+    if (!options.loss.empty()) {
+        channel = loss::make(options.loss, options.link, options.seed);
+        simulator.setChannel(channel.get());
+    }
+    int n = connections.size();
+    for (int i = 0; i < n; ++i) {
+        double position = n > 1 ? static_cast<double>(i) / (n - 1) : 0.0;
+        long long extraDelay = static_cast<long long>(options.rttSpread * position);
+        long long start = static_cast<long long>(options.startSpread * position);
+        simulator.addFlow(*connections[i], extraDelay, start);
+    }
+    report.simulation = simulator.run(options.duration);
+
+    const auto& flows = report.simulation.flows;
+    long long drops = 0;
+    std::vector<double> goodputs;
+    goodputs.reserve(n);
+    for (auto& flow : flows) {
+        drops += flow.drops;
+        goodputs.push_back(flow.goodput);
+    }
+    report.fairness = jainIndex(goodputs);
+
+    int first = 0;
+    for (auto& group : options.groups) {
+        GroupReport result;
+        result.algorithm = group.algorithm;
+        result.flows = group.count;
+        std::vector<double> values;
+        long long groupDrops = 0;
+        int sampled = 0;
+        for (int i = first; i < first + group.count; ++i) {
+            values.push_back(flows[i].goodput);
+            result.goodput += flows[i].goodput;
+            if (flows[i].baseRtt > 0 && flows[i].meanRtt > 0) {
+                result.rttInflation += flows[i].meanRtt / flows[i].baseRtt;
+                ++sampled;
+            }
+            groupDrops += flows[i].drops;
+        }
+        if (group.count > 0) {
+            result.fairness = jainIndex(values);
+        }
+        if (sampled > 0) {
+            result.rttInflation /= sampled;
+        }
+        result.lossShare = drops > 0 ? static_cast<double>(groupDrops) / drops : 0.0;
+        report.groups.push_back(result);
+        first += group.count;
+    }
+    return report;
+}
+
+} // namespace scenario
@@ -0,0 +1,57 @@
+#ifndef SCENARIO_HPP_INCLUDE
+#define SCENARIO_HPP_INCLUDE
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "bottleneck_link.hpp"
+#include "simulator.hpp"
+
+namespace scenario {
+
+struct FlowGroup {
+    std::string algorithm;
+    int count;
+};
+
+// Flows are laid out group after group. Flow i of n gets i/(n-1) of the spreads
+// as its extra one way delay and its start time.
+struct Options {
+    std::vector<FlowGroup> groups;
+    int packets = 10000; // per flow
+    int cwnd = 1;
+    int ssthresh = std::numeric_limits<int>::max();
+    long long rttSpread = 0;   // ns
+    long long startSpread = 0; // ns
+    long long duration = -1;   // ns, -1 runs until every flow is done
+    BottleneckLink::Config link;
+    std::string loss; // loss::make spec of a channel after the link, empty for none
+    uint64_t seed = 1;
+};
+
+struct GroupReport {
+    std::string algorithm;
+    int flows = 0;
+    double goodput = 0.0;      // Mbps, sum over the flows
+    double fairness = 0.0;     // Jain's index within the group
+    double rttInflation = 0.0; // mean of the flows' mean rtt over base rtt
+    double lossShare = 0.0;    // share of all drops at the link
+};
+
+struct Report {
+    Simulator::Report simulation;
+    std::vector<std::string> algorithms; // per flow
+    std::vector<GroupReport> groups;
+    double fairness = 0.0;
+};
+
+// (sum x)^2 / (n * sum x^2): 1 when every value is equal, 1/n when one takes all.
+double jainIndex(const std::vector<double>& values);
+
+Report run(const Options& options);
+
+} // namespace scenario
+
+#endif // SCENARIO_HPP_INCLUDE
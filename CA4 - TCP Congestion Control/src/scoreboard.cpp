@@ -0,0 +1,65 @@
+#include "scoreboard.hpp"
+
+namespace {
+
+constexpr int INITIAL_CAPACITY = 1024;
+
+} // namespace
+
+Scoreboard::Scoreboard()
+    : ring_(INITIAL_CAPACITY / 64, 0), capacity_(INITIAL_CAPACITY) {}
+
+int Scoreboard::getCumulative() const {
+    return base_;
+}
+
+bool Scoreboard::isAcked(int seq) const {
+    if (seq < base_) return true;
+    if (seq - base_ >= capacity_) return false;
+    return test(seq);
+}
+
+void Scoreboard::setAcked(int seq) {
+    if (seq < base_) return;
+    if (seq != base_) {
+        if (seq - base_ >= capacity_) {
+            grow(seq - base_ + 1);
+        }
+        int bit = seq & (capacity_ - 1);
+        ring_[bit >> 6] |= uint64_t(1) << (bit & 63);
+        return;
+    }
+
+    ++base_;
+    while (test(base_)) {
+        clear(base_);
+        ++base_;
+    }
+}
+
+bool Scoreboard::test(int seq) const {
+    int bit = seq & (capacity_ - 1);
+    return ring_[bit >> 6] >> (bit & 63) & 1;
+}
+
+void Scoreboard::clear(int seq) {
+    int bit = seq & (capacity_ - 1);
+    ring_[bit >> 6] &= ~(uint64_t(1) << (bit & 63));
+}
+
+// Doubles the ring until it spans the given distance from the cumulative point.
+void Scoreboard::grow(int span) {
+    int capacity = capacity_;
+    while (capacity < span) {
+        capacity *= 2;
+    }
+    std::vector<uint64_t> ring(capacity / 64, 0);
+    for (int seq = base_; seq < base_ + capacity_; ++seq) {
+        if (test(seq)) {
+            int bit = seq & (capacity - 1);
+            ring[bit >> 6] |= uint64_t(1) << (bit & 63);
+        }
+    }
+    ring_.swap(ring);
+    capacity_ = capacity;
+}
@@ -0,0 +1,31 @@
+#ifndef SCOREBOARD_HPP_INCLUDE
+#define SCOREBOARD_HPP_INCLUDE
+
+#include <cstdint>
+#include <vector>
+
+// Acknowledgement state of a sequence space. Everything below the cumulative
+// point is acknowledged and not stored; packets acknowledged above it (selective
+// acks) are bits of a ring that only spans up to the highest of them, so the
+// memory follows the window instead of the length of the transfer.
+class Scoreboard {
+public:
+    Scoreboard();
+
+    // First packet that is not acknowledged.
+    int getCumulative() const;
+
+    bool isAcked(int seq) const;
+    void setAcked(int seq);
+
+private:
+    int base_ = 0;
+    std::vector<uint64_t> ring_; // bit (seq % capacity) for seq in [base_, base_ + capacity)
+    int capacity_;
+
+    bool test(int seq) const;
+    void clear(int seq);
+    void grow(int span);
+};
+
+#endif // SCOREBOARD_HPP_INCLUDE
@@ -0,0 +1,398 @@
+#include "simulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int DUP_ACK_THRESHOLD = 3;
+constexpr long long INITIAL_RTO = NS_PER_SEC;
+constexpr long long MIN_RTO = 200 * NS_PER_MS;
+constexpr long long MAX_RTO = 60 * NS_PER_SEC;
+
+} // namespace
+
+Simulator::Simulator(const BottleneckLink::Config& link, uint64_t seed, uint64_t stream)
+    : link_(link, seed, stream) {}
+
+int Simulator::addFlow(TcpConnection& connection, long long extraDelay, long long start) {
+    int packets = connection.getPacketCount();
+    int window = (std::max(connection.getReceiveWindow(), 1) + 63) / 64 * 64;
+
+    Sender sender{};
+    sender.packets = packets;
+    sender.rto = INITIAL_RTO;
+    sender.srtt = -1;
+    sender.recover = -1;
+
+    Receiver receiver{};
+    receiver.packets = packets;
+    receiver.window = window;
+    receiver.offset = reorder_.size();
+    receiver.ackDelay = 2 * (link_.getConfig().delay + extraDelay);
+    reorder_.resize(reorder_.size() + window / 64, 0);
+
+    FlowStats stats{};
+    stats.extraDelay = extraDelay;
+    stats.start = start;
+    stats.finishedAt = -1;
+
+    long long recordOffset = -1;
+    if (connection.usesRateSamples()) {
+        recordOffset = records_.size();
+        records_.resize(records_.size() + window);
+    }
+
+    connections_.push_back(&connection);
+    senders_.push_back(sender);
+    receivers_.push_back(receiver);
+    pacers_.push_back(Pacer{start, false});
+    recordOffsets_.push_back(recordOffset);
+    flowStats_.push_back(stats);
+    return connections_.size() - 1;
+}
+
+Simulator::Report Simulator::run(long long until) {
+    active_ = 0;
+    for (int id = 0; id < static_cast<int>(senders_.size()); ++id) {
+        if (senders_[id].packets == 0) {
+            flowStats_[id].finishedAt = flowStats_[id].start;
+            continue;
+        }
+        ++active_;
+        events_.push(flowStats_[id].start, Event::Type::start, id);
+    }
+
+    long long events = 0;
+    long long transmissionTime = link_.getTransmissionTime();
+    while (active_ != 0 && !events_.empty()) {
+        if (until >= 0 && events_.top().time > until) {
+            now_ = until;
+            break;
+        }
+        Event event = events_.pop();
+        now_ = event.time;
+        ++events;
+        switch (event.type) {
+        case Event::Type::departure:
+            if (link_.getQueueLength() > 1) {
+                events_.push(now_ + transmissionTime, Event::Type::departure, -1);
+            }
+            depart();
+            break;
+        case Event::Type::ack:
+            onAck(event.flow, event.seq, event.stamp, event.trigger);
+            break;
+        case Event::Type::timeout:
+            onTimeout(event.flow);
+            break;
+        case Event::Type::start:
+            start(event.flow);
+            break;
+        case Event::Type::send:
+            onSend(event.flow);
+            break;
+        case Event::Type::arrival:
+            receive(BottleneckLink::Packet{event.flow, event.seq, event.stamp, 0});
+            break;
+        }
+    }
+    return makeReport(events);
+}
+
+void Simulator::start(int id) {
+    Sender& sender = senders_[id];
+    sendAvailable(id);
+    sender.timerAt = now_ + sender.rto;
+    armTimer(id);
+}
+
+// Sends new packets while the pipe, the packets sent but neither acknowledged
+// nor reported received by a duplicate ack, is below the congestion window. A
+// paced flow sends one packet per gap and waits for a send event in between.
+void Simulator::sendAvailable(int id) {
+    Sender& sender = senders_[id];
+    const TcpConnection& connection = *connections_[id];
+    int window = std::max(connection.getWindowSize(), 1);
+    int limit = std::min<long long>(sender.packets, static_cast<long long>(sender.sndUna) + receivers_[id].window);
+    double rate = connection.getPacingRate();
+    if (rate <= 0) {
+        while (sender.sndNxt < limit && sender.sndNxt - sender.sndUna - sender.dupAcks < window) {
+            sendPacket(id, sender.sndNxt++);
+        }
+        return;
+    }
+
+    Pacer& pacer = pacers_[id];
+    long long gap = std::max<long long>(1, std::llround(NS_PER_SEC / rate));
+    while (sender.sndNxt < limit && sender.sndNxt - sender.sndUna - sender.dupAcks < window) {
+        if (now_ < pacer.nextSendAt) {
+            if (!pacer.queued) {
+                events_.push(pacer.nextSendAt, Event::Type::send, id);
+                pacer.queued = true;
+            }
+            return;
+        }
+        sendPacket(id, sender.sndNxt++);
+        pacer.nextSendAt = std::max(pacer.nextSendAt, now_) + gap;
+    }
+}
+
+void Simulator::onSend(int id) {
+    pacers_[id].queued = false;
+    if (senders_[id].done()) return;
+    sendAvailable(id);
+}
+
+void Simulator::sendPacket(int id, int seq) {
+    Sender& sender = senders_[id];
+    ++sent_;
+    if (recordOffsets_[id] >= 0) {
+        FlowStats& stats = flowStats_[id];
+        if (sender.sndNxt - sender.sndUna - sender.dupAcks <= 1) {
+            stats.firstSentTime = now_;
+            stats.deliveredTime = now_;
+        }
+        SendRecord& record = records_[recordOffsets_[id] + seq % receivers_[id].window];
+        record = SendRecord{stats.delivered + stats.sacked, stats.deliveredTime, stats.firstSentTime, now_};
+    }
+    if (seq < sender.highSent) {
+        ++flowStats_[id].retransmits;
+    }
+    else {
+        sender.highSent = seq + 1;
+    }
+    if (!link_.enqueue(id, seq, now_, now_)) {
+        ++flowStats_[id].drops;
+    }
+    else if (link_.getQueueLength() == 1) {
+        events_.push(now_ + link_.getTransmissionTime(), Event::Type::departure, -1);
+    }
+}
+
+void Simulator::setChannel(loss::Model* channel) {
+    channel_ = channel;
+}
+
+void Simulator::depart() {
+    BottleneckLink::Packet packet = link_.dequeue(now_);
+    if (channel_ == nullptr) {
+        receive(packet);
+        return;
+    }
+    if (channel_->next()) {
+        ++channelDrops_;
+        ++flowStats_[packet.flow].drops;
+        return;
+    }
+    long long delay = channel_->getDelay();
+    if (delay > 0) {
+        events_.push(now_ + delay, Event::Type::arrival, packet.flow, packet.seq, packet.sentAt);
+    }
+    else {
+        receive(packet);
+    }
+}
+
+// The receiver side runs when the packet leaves the link, the ack then takes
+// the rest of the round trip propagation delay to get back to the sender.
+void Simulator::receive(const BottleneckLink::Packet& packet) {
+    Receiver& receiver = receivers_[packet.flow];
+    uint64_t* ring = reorder_.data() + receiver.offset;
+    int window = receiver.window;
+    if (packet.seq == receiver.expected) {
+        ++receiver.expected;
+        while (receiver.expected < receiver.packets) {
+            int bit = receiver.expected % window;
+            uint64_t mask = uint64_t(1) << (bit % 64);
+            if (!(ring[bit / 64] & mask)) break;
+            ring[bit / 64] &= ~mask;
+            ++receiver.expected;
+        }
+    }
+    else if (packet.seq > receiver.expected) {
+        int bit = packet.seq % window;
+        ring[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+    events_.push(now_ + receiver.ackDelay, Event::Type::ack, packet.flow, receiver.expected, packet.sentAt, packet.seq);
+}
+
+void Simulator::onAck(int id, int ack, long long stamp, int trigger) {
+    Sender& sender = senders_[id];
+    if (sender.done()) return;
+    TcpConnection& connection = *connections_[id];
+
+    if (ack > sender.sndUna) {
+        int acked = ack - sender.sndUna;
+        sender.sndUna = ack;
+        sender.sndNxt = std::max(sender.sndNxt, sender.sndUna);
+        sender.dupAcks = 0;
+        sender.retries = 0;
+        // Every duplicate ack stands for a packet that reached the receiver, so a
+        // cumulative ack only delivers the packets it covers beyond those.
+        FlowStats& stats = flowStats_[id];
+        stats.sacked -= std::min<long long>(acked - 1, stats.sacked);
+        stats.delivered += acked;
+        long long delivered = stats.delivered + stats.sacked;
+        long long sample = now_ - stamp;
+        updateRtt(id, sample);
+
+        bool partial = sender.inRecovery && ack < sender.recover;
+        AckEvent event{now_, sample, acked, sender.sndNxt - sender.sndUna, delivered, partial, -1.0, -1};
+        if (recordOffsets_[id] >= 0) {
+            // Rate sample as in draft-cheng-iccrg-delivery-rate-estimation: the
+            // packets delivered since the acked one was sent, over the longer of
+            // its send and ack intervals.
+            const SendRecord& record = records_[recordOffsets_[id] + trigger % receivers_[id].window];
+            stats.deliveredTime = now_;
+            stats.firstSentTime = record.sentAt;
+            long long interval = std::max(record.sentAt - record.firstSentTime, now_ - record.deliveredTime);
+            if (interval > 0) {
+                event.deliveryRate = static_cast<double>(delivered - record.delivered) * NS_PER_SEC / interval;
+            }
+            event.priorDelivered = record.delivered;
+        }
+        if (connection.onAck(event) && partial) {
+            sendPacket(id, sender.sndUna);
+        }
+        else {
+            sender.inRecovery = false;
+        }
+        stats.cwndSum += connection.getWindowSize();
+
+        if (sender.sndUna == sender.packets) {
+            finish(id);
+            return;
+        }
+        sender.timerAt = now_ + sender.rto;
+        armTimer(id);
+    }
+    else if (ack == sender.sndUna && sender.sndNxt > sender.sndUna) {
+        ++sender.dupAcks;
+        FlowStats& stats = flowStats_[id];
+        stats.sacked += stats.sacked < sender.sndNxt - sender.sndUna - 1;
+        stats.deliveredTime = now_;
+        // As in RFC 6582, duplicate acks that do not cover every packet sent
+        // before the last recovery or timeout come from its retransmissions and
+        // start no new recovery.
+        if (sender.dupAcks == DUP_ACK_THRESHOLD && !sender.inRecovery && ack > sender.recover) {
+            ++stats.fastRetransmits;
+            sender.inRecovery = true;
+            sender.recover = sender.sndNxt;
+            connection.onLoss(LossEvent::tripleDupAck);
+            sendPacket(id, sender.sndUna);
+        }
+        else {
+            int inflight = std::max(sender.sndNxt - sender.sndUna - sender.dupAcks, 0);
+            connection.onAck(AckEvent{now_, -1, 0, inflight, stats.delivered + stats.sacked, false, -1.0, -1});
+        }
+    }
+    sendAvailable(id);
+}
+
+// Timers are lazy: restarting one only moves timerAt, and the queued event
+// goes back into the queue if it fires before the deadline.
+void Simulator::onTimeout(int id) {
+    Sender& sender = senders_[id];
+    sender.timerQueued = false;
+    if (sender.done()) return;
+    if (now_ < sender.timerAt) {
+        armTimer(id);
+        return;
+    }
+
+    ++flowStats_[id].timeouts;
+    if (++sender.retries > MAX_RETRIES) {
+        ++abandoned_;
+        --active_;
+        return;
+    }
+    connections_[id]->onLoss(LossEvent::timeout);
+    sender.sndNxt = sender.sndUna;
+    sender.dupAcks = 0;
+    sender.inRecovery = false;
+    sender.recover = sender.highSent;
+    sender.rto = std::min(sender.rto * 2, MAX_RTO);
+    sender.timerAt = now_ + sender.rto;
+    armTimer(id);
+    sendAvailable(id);
+}
+
+void Simulator::finish(int id) {
+    flowStats_[id].finishedAt = now_;
+    --active_;
+}
+
+void Simulator::updateRtt(int id, long long sample) {
+    Sender& sender = senders_[id];
+    FlowStats& stats = flowStats_[id];
+    stats.rttSum += sample;
+    ++stats.rttSamples;
+    if (sender.srtt < 0) {
+        sender.srtt = sample;
+        sender.rttvar = sample / 2;
+    }
+    else {
+        long long error = sender.srtt > sample ? sender.srtt - sample : sample - sender.srtt;
+        sender.rttvar = (3 * sender.rttvar + error) / 4;
+        sender.srtt = (7 * sender.srtt + sample) / 8;
+    }
+    sender.rto = std::clamp(sender.srtt + 4 * sender.rttvar, MIN_RTO, MAX_RTO);
+}
+
+void Simulator::armTimer(int id) {
+    Sender& sender = senders_[id];
+    if (sender.timerQueued) return;
+    events_.push(sender.timerAt, Event::Type::timeout, id);
+    sender.timerQueued = true;
+}
+
+Simulator::Report Simulator::makeReport(long long events) {
+    Report report;
+    report.events = events;
+    report.sent = sent_;
+    report.link = link_.getStats();
+    report.channelDrops = channelDrops_;
+    report.abandoned = abandoned_;
+    report.duration = active_ != 0 || abandoned_ != 0 ? now_ : 0;
+
+    double bits = link_.getConfig().packetSize * 8.0;
+    long long transmissionTime = link_.getTransmissionTime();
+    report.flows.resize(flowStats_.size());
+    for (size_t id = 0; id < flowStats_.size(); ++id) {
+        const FlowStats& stats = flowStats_[id];
+        FlowReport& flow = report.flows[id];
+        flow.delivered = stats.delivered;
+        flow.drops = stats.drops;
+        flow.retransmits = stats.retransmits;
+        flow.timeouts = stats.timeouts;
+        flow.fastRetransmits = stats.fastRetransmits;
+        flow.start = stats.start;
+        flow.finishedAt = stats.finishedAt;
+        long long end = stats.finishedAt >= 0 ? stats.finishedAt : now_;
+        if (end > stats.start) {
+            flow.goodput = stats.delivered * bits * 1000.0 / (end - stats.start);
+        }
+        if (stats.rttSamples > 0) {
+            flow.meanRtt = static_cast<double>(stats.rttSum) / stats.rttSamples / NS_PER_MS;
+            flow.meanCwnd = static_cast<double>(stats.cwndSum) / stats.rttSamples;
+        }
+        flow.baseRtt = static_cast<double>(receivers_[id].ackDelay + transmissionTime) / NS_PER_MS;
+
+        report.duration = std::max(report.duration, stats.finishedAt);
+        report.delivered += stats.delivered;
+        report.retransmits += stats.retransmits;
+        report.timeouts += stats.timeouts;
+        report.fastRetransmits += stats.fastRetransmits;
+    }
+
+    if (report.duration > 0) {
+        report.throughput = report.delivered * bits * 1000.0 / report.duration;
+        report.utilization = static_cast<double>(report.link.transmitted) * transmissionTime / report.duration;
+    }
+    if (report.link.transmitted > 0) {
+        report.meanQueueDelay = static_cast<double>(report.link.queueDelaySum) / report.link.transmitted / NS_PER_MS;
+    }
+    report.maxQueueDelay = static_cast<double>(report.link.maxQueueDelay) / NS_PER_MS;
+    return report;
+}
@@ -0,0 +1,162 @@
+#ifndef SIMULATOR_HPP_INCLUDE
+#define SIMULATOR_HPP_INCLUDE
+
+#include <cstdint>
+#include <vector>
+
+#include "bottleneck_link.hpp"
+#include "event_queue.hpp"
+#include "loss_model.hpp"
+#include "tcp_connection.hpp"
+
+// Discrete event model of TcpConnections sending over a shared BottleneckLink.
+// The senders keep the transport state (cumulative acks, duplicate ack counting,
+// go-back-N after a timeout, RFC 6298 retransmission timer) and leave the window
+// to the connection through onAck and onLoss. Receivers ack every packet on an
+// uncongested reverse path, echoing the send time of the packet. Connections
+// that ask for it get a delivery rate sample with every new ack and their sends
+// spaced by their pacing rate.
+class Simulator {
+public:
+    struct FlowReport {
+        long long delivered = 0;
+        long long drops = 0;
+        long long retransmits = 0;
+        long long timeouts = 0;
+        long long fastRetransmits = 0;
+        long long start = 0;
+        long long finishedAt = -1; // -1 when the run ended first or the flow gave up
+        double goodput = 0.0;      // Mbps between the start and the end of the flow
+        double meanRtt = 0.0;      // ms over the rtt samples
+        double baseRtt = 0.0;      // ms of an empty queue
+        double meanCwnd = 0.0;     // over the new acks
+    };
+
+    struct Report {
+        long long duration = 0;      // ns until the last packet was acknowledged
+        long long delivered = 0;
+        long long sent = 0;
+        long long retransmits = 0;
+        long long timeouts = 0;
+        long long fastRetransmits = 0;
+        long long events = 0;
+        double throughput = 0.0;     // Mbps of goodput
+        double utilization = 0.0;    // share of the duration the link was busy
+        double meanQueueDelay = 0.0; // ms
+        double maxQueueDelay = 0.0;  // ms
+        long long channelDrops = 0;
+        long long abandoned = 0;     // flows that gave up, see MAX_RETRIES
+        BottleneckLink::Stats link;
+        std::vector<FlowReport> flows;
+    };
+
+    // Timeouts in a row after which a flow gives up, like tcp_retries2 of Linux,
+    // so that a channel that loses every retransmission cannot run forever.
+    static constexpr int MAX_RETRIES = 15;
+
+    Simulator(const BottleneckLink::Config& link, uint64_t seed = 1, uint64_t stream = 0);
+
+    // extraDelay is one way propagation delay of the flow on top of the link's,
+    // added on the way back so that the flows share the queue in send order.
+    int addFlow(TcpConnection& connection, long long extraDelay = 0, long long start = 0);
+
+    // Lossy channel after the link: the packets it loses never reach the
+    // receiver and the others are delayed by its extra delay.
+    void setChannel(loss::Model* channel);
+
+    // Runs until every flow has its packets acknowledged, or until the given time.
+    Report run(long long until = -1);
+
+private:
+    // Per flow state lives in parallel arrays split by access pattern: senders_
+    // is touched on every ack, receivers_ and the reorder bitmaps on every
+    // departure, and flowStats_ only on rarer events and for the report.
+    struct alignas(64) Sender {
+        int packets;
+        int sndUna;   // first unacknowledged packet
+        int sndNxt;   // next packet to send
+        int highSent;
+        int dupAcks;
+        int recover;
+        int retries; // timeouts since the last new ack
+        bool inRecovery;
+        bool timerQueued;
+        long long srtt;
+        long long rttvar;
+        long long rto;
+        long long timerAt;
+
+        // Every packet is acknowledged, or the flow gave up.
+        bool done() const { return sndUna == packets || retries > MAX_RETRIES; }
+    };
+
+    struct Receiver {
+        int packets;
+        int expected;
+        int window;           // bits of the reorder ring, a multiple of 64
+        size_t offset;        // first word of the ring in reorder_
+        long long ackDelay;   // from the departure to the ack reaching the sender
+    };
+
+    // Flow state at the time a packet was sent, for the delivery rate samples.
+    struct SendRecord {
+        long long delivered;
+        long long deliveredTime;
+        long long firstSentTime;
+        long long sentAt;
+    };
+
+    struct Pacer {
+        long long nextSendAt;
+        bool queued;
+    };
+
+    struct FlowStats {
+        long long delivered;
+        long long sacked; // reported by duplicate acks, not yet cumulatively acked
+        long long drops;
+        long long retransmits;
+        long long timeouts;
+        long long fastRetransmits;
+        long long rttSum;
+        long long rttSamples;
+        long long cwndSum;
+        long long deliveredTime;
+        long long firstSentTime;
+        long long extraDelay;
+        long long start;
+        long long finishedAt;
+    };
+
+    BottleneckLink link_;
+    loss::Model* channel_ = nullptr;
+    long long channelDrops_ = 0;
+    EventQueue events_;
+    std::vector<TcpConnection*> connections_;
+    std::vector<Sender> senders_;
+    std::vector<Receiver> receivers_;
+    std::vector<uint64_t> reorder_;
+    std::vector<Pacer> pacers_;
+    std::vector<long long> recordOffsets_; // first record of a flow in records_, -1 without
+    std::vector<SendRecord> records_;
+    std::vector<FlowStats> flowStats_;
+    long long now_ = 0;
+    long long sent_ = 0;
+    int active_ = 0;
+    int abandoned_ = 0;
+
+    void start(int id);
+    void sendAvailable(int id);
+    void sendPacket(int id, int seq);
+    void depart();
+    void receive(const BottleneckLink::Packet& packet);
+    void onAck(int id, int ack, long long stamp, int trigger);
+    void onSend(int id);
+    void onTimeout(int id);
+    void finish(int id);
+    void updateRtt(int id, long long sample);
+    void armTimer(int id);
+    Report makeReport(long long events);
+};
+
+#endif // SIMULATOR_HPP_INCLUDE
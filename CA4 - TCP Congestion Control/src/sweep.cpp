@@ -0,0 +1,183 @@
+#include "sweep.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+#include "algorithms.hpp"
+#include "loss_model.hpp"
+#include "simulator.hpp"
+
+namespace sweep {
+
+namespace {
+
+const char* const METRIC_NAMES[METRIC_COUNT] = {
+    "duration", "throughput", "loss_events", "mean_cwnd", "utilization", "queue_delay", "retransmits",
+};
+
+// Two sided 95% quantiles of Student's t for 1 to 30 degrees of freedom.
+const double T_95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+struct Config {
+    std::string algorithm;
+    int cwnd;
+    int ssthresh;
+    std::string loss;
+};
+
+struct Sample {
+    double values[METRIC_COUNT];
+};
+
+Sample runOnce(const Options& options, const Config& config, int index) {
+    Sample sample;
+    std::fill(std::begin(sample.values), std::end(sample.values), std::nan(""));
+    auto connection = algorithms::make(config.algorithm, options.packets, config.cwnd, config.ssthresh);
+    connection->setSeed(options.seed, index);
+
+    double bits = options.link.packetSize * 8.0;
+    bool events = config.loss == "droptail" || config.loss == "red";
+    if (!events) {
+        if (config.loss != "exp") {
+            connection->setLossModel(loss::make(config.loss, options.link, options.seed, index));
+        }
+        RoundStats stats = connection->runRounds(nullptr);
+        BottleneckLink link(options.link);
+        double rtt = static_cast<double>(2 * options.link.delay + link.getTransmissionTime()) / NS_PER_SEC;
+        double seconds = stats.rounds * rtt;
+        sample.values[duration] = seconds;
+        sample.values[throughput] = seconds > 0 ? options.packets * bits / seconds / 1e6 : 0.0;
+        sample.values[lossEvents] = stats.lossRounds;
+        sample.values[meanCwnd] = stats.rounds > 0 ? static_cast<double>(stats.cwndSum) / stats.rounds : 0.0;
+        return sample;
+    }
+
+    BottleneckLink::Config link = options.link;
+    link.queue = config.loss == "red" ? BottleneckLink::Queue::red : BottleneckLink::Queue::dropTail;
+    Simulator simulator(link, options.seed, index);
+    simulator.addFlow(*connection);
+    Simulator::Report report = simulator.run();
+    sample.values[duration] = static_cast<double>(report.duration) / NS_PER_SEC;
+    sample.values[throughput] = report.throughput;
+    sample.values[lossEvents] = report.fastRetransmits + report.timeouts;
+    sample.values[meanCwnd] = report.flows[0].meanCwnd;
+    sample.values[utilization] = report.utilization;
+    sample.values[queueDelay] = report.meanQueueDelay;
+    sample.values[retransmits] = report.retransmits;
+    return sample;
+}
+
+Summary summarize(const Config& config, const Sample* samples, int count) {
+    Summary summary;
+    summary.algorithm = config.algorithm;
+    summary.cwnd = config.cwnd;
+    summary.ssthresh = config.ssthresh;
+    summary.loss = config.loss;
+    summary.runs = count;
+    for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+        // Welford's running mean and variance.
+        double mean = 0.0;
+        double squares = 0.0;
+        for (int i = 0; i < count; ++i) {
+            double value = samples[i].values[metric];
+            double delta = value - mean;
+            mean += delta / (i + 1);
+            squares += delta * (value - mean);
+        }
+        summary.mean[metric] = mean;
+        if (count < 2) {
+            summary.ci[metric] = std::isnan(mean) ? mean : 0.0;
+            continue;
+        }
+        int df = count - 1;
+        double t = df <= 30 ? T_95[df - 1] : 1.96;
+        summary.ci[metric] = t * std::sqrt(squares / df / count);
+    }
+    return summary;
+}
+
+} // namespace
+
+bool validLossModel(const std::string& name) {
+    if (name == "exp" || name == "droptail" || name == "red") return true;
+    return loss::make(name, BottleneckLink::Config{}, 0) != nullptr;
+}
+
+std::vector<Summary> run(const Options& options) {
+    std::vector<Config> configs;
+    for (auto& algorithm : options.algorithms) {
+        for (int cwnd : options.cwnds) {
+            for (int ssthresh : options.ssthresholds) {
+                for (auto& model : options.losses) {
+                    configs.push_back(Config{algorithm, cwnd, ssthresh, model});
+                }
+            }
+        }
+    }
+
+    int seeds = std::max(options.seeds, 1);
+    size_t total = configs.size() * seeds;
+    std::vector<Sample> samples(total);
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < total; i = next++) {
+            samples[i] = runOnce(options, configs[i / seeds], i % seeds);
+        }
+    };
+
+    int threads = options.threads > 0 ? options.threads : std::thread::hardware_concurrency();
+    threads = std::max<int>(1, std::min<size_t>(threads, total));
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    std::vector<Summary> summaries;
+    summaries.reserve(configs.size());
+    for (size_t i = 0; i < configs.size(); ++i) {
+        summaries.push_back(summarize(configs[i], samples.data() + i * seeds, seeds));
+    }
+    return summaries;
+}
+
+void writeCsv(std::ostream& os, const std::vector<Summary>& summaries) {
+    os << "algorithm,cwnd,ssthresh,loss,runs";
+    for (const char* name : METRIC_NAMES) {
+        os << ',' << name << "_mean," << name << "_ci";
+    }
+    os << '\n';
+
+    auto writeValue = [&os](double value) {
+        os << ',';
+        if (!std::isnan(value)) {
+            os << value;
+        }
+    };
+    for (auto& summary : summaries) {
+        os << summary.algorithm << ',' << summary.cwnd << ',';
+        if (summary.ssthresh == std::numeric_limits<int>::max()) {
+            os << "inf";
+        }
+        else {
+            os << summary.ssthresh;
+        }
+        os << ',' << summary.loss << ',' << summary.runs;
+        for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+            writeValue(summary.mean[metric]);
+            writeValue(summary.ci[metric]);
+        }
+        os << '\n';
+    }
+}
+
+} // namespace sweep
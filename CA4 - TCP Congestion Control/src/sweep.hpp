@@ -0,0 +1,63 @@
+#ifndef SWEEP_HPP_INCLUDE
+#define SWEEP_HPP_INCLUDE
+
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "bottleneck_link.hpp"
+
+namespace sweep {
+
+// Loss models of the grid: exp is the round model with the loss probability
+// growing with cwnd (packetLost), droptail and red the event model with that
+// queue at the bottleneck, and any other name a loss::make spec for the round
+// model, with run i of a configuration on stream i.
+bool validLossModel(const std::string& name);
+
+struct Options {
+    std::vector<std::string> algorithms{"reno", "newreno", "bbr"};
+    std::vector<int> cwnds{1};
+    std::vector<int> ssthresholds{std::numeric_limits<int>::max()};
+    std::vector<std::string> losses{"exp"};
+    int seeds = 10;    // runs per configuration
+    uint64_t seed = 1; // Philox key, run i of a configuration uses stream i
+    int packets = 10000;
+    int threads = 0;   // 0 uses every hardware thread
+    BottleneckLink::Config link;
+};
+
+enum Metric {
+    duration,    // s, rounds of the round model count as one base rtt each
+    throughput,  // Mbps
+    lossEvents,  // lossy rounds, or fast retransmits and timeouts
+    meanCwnd,
+    utilization, // event model only
+    queueDelay,  // ms, event model only
+    retransmits, // event model only
+    METRIC_COUNT
+};
+
+struct Summary {
+    std::string algorithm;
+    int cwnd;
+    int ssthresh;
+    std::string loss;
+    int runs = 0;
+    // NaN for the metrics the loss model does not have. ci is the half width of
+    // the 95% confidence interval of the mean (Student's t).
+    double mean[METRIC_COUNT];
+    double ci[METRIC_COUNT];
+};
+
+// Runs every configuration of the grid seeds times on a pool of threads. The
+// summaries come in grid order and do not depend on the thread count.
+std::vector<Summary> run(const Options& options);
+
+void writeCsv(std::ostream& os, const std::vector<Summary>& summaries);
+
+} // namespace sweep
+
+#endif // SWEEP_HPP_INCLUDE
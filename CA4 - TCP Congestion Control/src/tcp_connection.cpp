@@ -1,46 +1,144 @@
 #include "tcp_connection.hpp"
 
+#include "loss_model.hpp"
+#include "trace.hpp"
 #include "utils.hpp"
 
-TcpConnection::TcpConnection(const std::vector<int>& data) {
-    packetize(data);
-}
+TcpConnection::TcpConnection(int packets)
+    : packetCount_(packets) {}
 
-TcpConnection::TcpConnection(const std::vector<int>& data, int cwnd, int thold)
-    : TcpConnection(data) {
+TcpConnection::TcpConnection(int packets, int cwnd, int thold)
+    : TcpConnection(packets) {
     cwnd_ = cwnd;
     ssthresh_ = thold;
 }
 
+TcpConnection::~TcpConnection() = default;
+
 int TcpConnection::getWindowSize() const {
     return std::min(cwnd_, awnd_);
 }
 
-void TcpConnection::packetize(const std::vector<int>& data) {
-    packets_.reserve(data.size());
-    for (int d : data) {
-        Packet p{};
-        p.data = d;
-        p.acked = false;
-        packets_.push_back(p);
-    }
+double TcpConnection::getPacingRate() const {
+    return 0.0;
+}
+
+bool TcpConnection::usesRateSamples() const {
+    return false;
+}
+
+Phase TcpConnection::getPhase() const {
+    return cwnd_ < ssthresh_ ? Phase::slowStart : Phase::congestionAvoidance;
+}
+
+int TcpConnection::getReceiveWindow() const {
+    return awnd_;
+}
+
+int TcpConnection::getPacketCount() const {
+    return packetCount_;
+}
+
+Packet TcpConnection::getPacket(int seq) const {
+    Packet p{};
+    p.tcpHeader.seqNum = seq;
+    p.tcpHeader.advWindow = awnd_;
+    p.data = seq;
+    p.acked = scoreboard_.isAcked(seq);
+    return p;
 }
 
-bool TcpConnection::packetLost() const {
+bool TcpConnection::packetLost() {
+    if (lossModel_ != nullptr) return lossModel_->next();
     int p = static_cast<int>(awnd_ * utils::expProb(cwnd_, 1, awnd_));
-    int rand = utils::randInt(1, awnd_);
+    int rand = utils::randInt(gen_, 1, awnd_);
     return rand <= p;
 }
 
-void TcpConnection::run(std::ostream& os) {
-    while (sw_.lastAck != static_cast<int>(packets_.size() - 1)) {
-        log(os);
+// Packets are acknowledged in order up to the first loss. After it, every
+// packet that gets through is a duplicate ack: without selective acks the
+// window ends at the third one, with them the packets are kept as acked and
+// skipped by the next windows, which grow by the packets they skip.
+void TcpConnection::sendWindow(bool selective) {
+    if (timeout_ != 0) return;
+    if (sw_.lastAck == packetCount_ - 1) return;
+
+    lostCount_ = 0;
+    ackAfterLoss_ = 0;
+    int startAck = sw_.lastAck + 1;
+    int sackCount = 0;
+    for (int i = startAck; i < startAck + sackCount + cwnd_ && i < packetCount_; ++i) {
+        if (selective && scoreboard_.isAcked(i)) {
+            ++sackCount;
+            if (lostCount_ == 0) {
+                ++sw_.lastAck;
+            }
+            continue;
+        }
+        if (packetLost()) {
+            ++lostCount_;
+        }
+        else if (lostCount_ == 0) {
+            ++sw_.lastAck;
+            scoreboard_.setAcked(i);
+        }
+        else {
+            ++ackAfterLoss_;
+            if (selective) {
+                scoreboard_.setAcked(i);
+            }
+            else if (ackAfterLoss_ == RETRANSMIT_ACKS) {
+                break;
+            }
+        }
+    }
+}
+
+RoundStats TcpConnection::run(std::ostream& os) {
+    return runRounds(&os);
+}
+
+RoundStats TcpConnection::runRounds(std::ostream* os, trace::Sink* sink) {
+    RoundStats stats;
+    int stalledRounds = 0;
+    while (sw_.lastAck != packetCount_ - 1) {
+        if (stalledRounds == MAX_STALLED_ROUNDS) {
+            stats.stalled = true;
+            break;
+        }
+        int lastAck = sw_.lastAck;
+        if (os != nullptr) {
+            log(*os);
+        }
+        trace::Record record{static_cast<uint32_t>(rtt_), cwnd_, ssthresh_, static_cast<uint8_t>(getPhase()), 0, 0};
+        stats.cwndSum += cwnd_;
+        if (lossModel_ != nullptr) {
+            lossModel_->startRound(cwnd_);
+        }
         sendData();
         if (!onPacketLoss()) {
             onRttUpdate();
         }
+        else {
+            ++stats.lossRounds;
+            record.loss = 1;
+        }
+        if (sink != nullptr) {
+            sink->write(record);
+        }
         ++rtt_;
+        ++stats.rounds;
+        stalledRounds = sw_.lastAck == lastAck ? stalledRounds + 1 : 0;
     }
+    return stats;
+}
+
+void TcpConnection::setSeed(uint64_t seed, uint64_t stream) {
+    gen_.reset(seed, stream);
+}
+
+void TcpConnection::setLossModel(std::unique_ptr<loss::Model> model) {
+    lossModel_ = std::move(model);
 }
 
 void TcpConnection::log(std::ostream& os) const {
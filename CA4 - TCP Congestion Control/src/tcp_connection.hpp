@@ -2,25 +2,106 @@
 #define TCP_CONNECTION_HPP_INCLUDE
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
+#include <memory>
 #include <ostream>
-#include <vector>
 
 #include "packet.hpp"
+#include "philox.hpp"
+#include "scoreboard.hpp"
 
 constexpr int TIMEOUT_WAITTIME = 2;
+constexpr int RETRANSMIT_ACKS = 3;
+// Rounds without a new ack after which the round model gives up on the transfer.
+constexpr int MAX_STALLED_ROUNDS = 1000;
+
+constexpr long long NS_PER_MS = 1000000;
+constexpr long long NS_PER_SEC = 1000000000;
+
+// Feedback of the event driven simulator (simulator.hpp), times in nanoseconds.
+struct AckEvent {
+    long long time;
+    long long rtt;       // -1 when the ack carries no sample
+    int acked;           // packets newly acknowledged, 0 for a duplicate ack
+    int inflight;        // packets still in the network after this ack
+    long long delivered; // packets acknowledged so far, with those reported by duplicate acks
+    bool partial;        // in recovery and below the highest packet sent at the loss
+
+    // Delivery rate sample of connections that use them (usesRateSamples).
+    double deliveryRate;      // packets per second, -1 without a sample
+    long long priorDelivered; // delivered when the packet that caused the ack was sent
+};
+
+enum class LossEvent {
+    tripleDupAck,
+    timeout,
+};
+
+// Congestion control state of a connection, in the terms of all the algorithms.
+enum class Phase : uint8_t {
+    slowStart,
+    congestionAvoidance,
+    recovery,
+    startup,
+    drain,
+    probeBw,
+    probeRtt,
+};
+
+constexpr int PHASE_COUNT = 7;
+
+namespace loss {
+class Model;
+} // namespace loss
+
+namespace trace {
+class Sink;
+} // namespace trace
+
+struct RoundStats {
+    int rounds = 0;
+    long long cwndSum = 0;
+    int lossRounds = 0; // rounds in which onPacketLoss reported a loss or a timeout
+    bool stalled = false; // gave up after MAX_STALLED_ROUNDS rounds without a new ack
+};
 
 class TcpConnection {
 public:
-    TcpConnection(const std::vector<int>& data);
-    TcpConnection(const std::vector<int>& data, int cwnd, int thold);
-    virtual ~TcpConnection() = default;
+    // The payload of packet i is i, synthesized when the packet is built.
+    TcpConnection(int packets);
+    TcpConnection(int packets, int cwnd, int thold);
+    virtual ~TcpConnection();
 
     virtual void sendData() = 0;
     virtual bool onPacketLoss() = 0;
     virtual void onRttUpdate() = 0;
 
-    void run(std::ostream& os);
+    // Per packet callbacks of the event driven simulator. onAck returns true when
+    // the first unacknowledged packet has to be retransmitted right away.
+    virtual bool onAck(const AckEvent& ack) = 0;
+    virtual void onLoss(LossEvent loss) = 0;
+    // Packets per second the simulator spaces the sends at, 0 sends the window at once.
+    virtual double getPacingRate() const;
+    virtual bool usesRateSamples() const;
+    // Slow start below ssthresh and congestion avoidance above by default.
+    virtual Phase getPhase() const;
+
+    RoundStats run(std::ostream& os);
+    // Same as run, os may be null to only collect the statistics. Every round
+    // is also passed to the sink if there is one. Stops when every packet is
+    // acknowledged, or after MAX_STALLED_ROUNDS rounds without a new ack.
+    RoundStats runRounds(std::ostream* os, trace::Sink* sink = nullptr);
+
+    // The losses of the round model are drawn from a Philox stream of this seed.
+    void setSeed(uint64_t seed, uint64_t stream = 0);
+    // Replaces the cwnd dependent loss of the round model.
+    void setLossModel(std::unique_ptr<loss::Model> model);
+
+    int getWindowSize() const;
+    int getReceiveWindow() const;
+    int getPacketCount() const;
+    Packet getPacket(int seq) const;
 
 protected:
     const int awnd_ = 1000;
@@ -29,11 +110,18 @@ protected:
     int rtt_ = 0;
     int timeout_ = 0;
 
-    std::vector<Packet> packets_;
+    int packetCount_;
+    Scoreboard scoreboard_;
     SlidingWindow sw_{-1, -1, -1};
-    int getWindowSize() const;
-    void packetize(const std::vector<int>& data);
-    bool packetLost() const;
+    Philox gen_;
+    std::unique_ptr<loss::Model> lossModel_;
+    bool packetLost();
+
+    // Outcome of the last sendWindow.
+    int lostCount_ = 0;
+    int ackAfterLoss_ = 0;
+    // Sends one window of the round model, see tcp_connection.cpp.
+    void sendWindow(bool selective);
     void log(std::ostream& os) const;
 };
 
@@ -0,0 +1,139 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+
+namespace trace {
+
+namespace {
+
+constexpr char MAGIC[8] = {'T', 'C', 'P', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t READ_RECORDS = 4096;
+
+} // namespace
+
+std::string getName(Phase phase) {
+    switch (phase) {
+    case Phase::slowStart: return "slow_start";
+    case Phase::congestionAvoidance: return "congestion_avoidance";
+    case Phase::recovery: return "recovery";
+    case Phase::startup: return "startup";
+    case Phase::drain: return "drain";
+    case Phase::probeBw: return "probe_bw";
+    case Phase::probeRtt: return "probe_rtt";
+    }
+    return "";
+}
+
+Writer::Writer(const std::string& path)
+    : file_(path, std::ios::binary) {
+    buffer_.reserve(BUFFER_RECORDS);
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.recordSize = sizeof(Record);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+Writer::~Writer() {
+    flush();
+}
+
+bool Writer::good() const {
+    return file_.good();
+}
+
+void Writer::write(const Record& record) {
+    buffer_.push_back(record);
+    if (buffer_.size() == BUFFER_RECORDS) {
+        flush();
+    }
+}
+
+void Writer::flush() {
+    if (buffer_.empty()) return;
+    file_.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size() * sizeof(Record));
+    file_.flush();
+    buffer_.clear();
+}
+
+void Stats::write(const Record& record) {
+    int cwnd = std::max(record.cwnd, 0);
+    if (static_cast<size_t>(cwnd) >= cwndCounts_.size()) {
+        cwndCounts_.resize(cwnd + 1, 0);
+    }
+    ++cwndCounts_[cwnd];
+    cwndSum_ += cwnd;
+    ++rounds_;
+    lossRounds_ += record.loss;
+    if (record.phase < PHASE_COUNT) {
+        ++phaseRounds_[record.phase];
+    }
+}
+
+long long Stats::getRounds() const {
+    return rounds_;
+}
+
+long long Stats::getLossRounds() const {
+    return lossRounds_;
+}
+
+long long Stats::getPhaseRounds(Phase phase) const {
+    return phaseRounds_[static_cast<int>(phase)];
+}
+
+double Stats::getMeanCwnd() const {
+    return rounds_ > 0 ? static_cast<double>(cwndSum_) / rounds_ : 0.0;
+}
+
+int Stats::getCwndPercentile(double share) const {
+    long long target = static_cast<long long>(std::ceil(share * rounds_));
+    long long seen = 0;
+    for (size_t cwnd = 0; cwnd < cwndCounts_.size(); ++cwnd) {
+        seen += cwndCounts_[cwnd];
+        if (seen >= std::max(target, 1LL)) return static_cast<int>(cwnd);
+    }
+    return 0;
+}
+
+void Stats::print(std::ostream& os) const {
+    os << std::fixed << std::setprecision(3)
+       << "rounds: " << rounds_ << '\n'
+       << "loss rounds: " << lossRounds_ << '\n'
+       << "cwnd: mean " << getMeanCwnd() << ", min " << getCwndPercentile(0.0)
+       << ", p50 " << getCwndPercentile(0.5) << ", p90 " << getCwndPercentile(0.9)
+       << ", p99 " << getCwndPercentile(0.99) << ", max " << getCwndPercentile(1.0) << '\n';
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        if (phaseRounds_[phase] == 0) continue;
+        os << getName(static_cast<Phase>(phase)) << ": " << phaseRounds_[phase] << " rounds ("
+           << 100.0 * phaseRounds_[phase] / rounds_ << " %)\n";
+    }
+}
+
+bool writeCsv(std::istream& is, std::ostream& os) {
+    Header header{};
+    is.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!is || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION || header.recordSize != sizeof(Record)) {
+        return false;
+    }
+
+    os << "round,cwnd,ssthresh,phase,loss\n";
+    std::vector<Record> records(READ_RECORDS);
+    while (is) {
+        is.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(Record));
+        size_t count = is.gcount() / sizeof(Record);
+        for (size_t i = 0; i < count; ++i) {
+            const Record& record = records[i];
+            os << record.round << ',' << record.cwnd << ',' << record.ssthresh << ','
+               << getName(static_cast<Phase>(record.phase)) << ',' << int(record.loss) << '\n';
+        }
+    }
+    return true;
+}
+
+} // namespace trace
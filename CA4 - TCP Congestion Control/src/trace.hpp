@@ -0,0 +1,88 @@
+#ifndef TRACE_HPP_INCLUDE
+#define TRACE_HPP_INCLUDE
+
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "tcp_connection.hpp"
+
+namespace trace {
+
+// A trace file is a Header followed by one Record per round of the round model,
+// both in host byte order.
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+struct Record {
+    uint32_t round;
+    int32_t cwnd;     // at the start of the round
+    int32_t ssthresh;
+    uint8_t phase;    // Phase at the start of the round
+    uint8_t loss;     // 1 when the round ended in a loss or a timeout
+    uint16_t reserved;
+};
+
+static_assert(sizeof(Header) == 16, "trace header is 16 bytes");
+static_assert(sizeof(Record) == 16, "trace record is 16 bytes");
+
+std::string getName(Phase phase);
+
+class Sink {
+public:
+    virtual ~Sink() = default;
+    virtual void write(const Record& record) = 0;
+};
+
+// Collects records in a buffer and writes them to the file in blocks.
+class Writer : public Sink {
+public:
+    explicit Writer(const std::string& path);
+    ~Writer() override;
+
+    bool good() const;
+    void write(const Record& record) override;
+    void flush();
+
+private:
+    static constexpr size_t BUFFER_RECORDS = 4096;
+
+    std::ofstream file_;
+    std::vector<Record> buffer_;
+};
+
+// Summary of a run kept while it runs: the cwnd distribution as a count per
+// value, the rounds spent in each phase and the lossy rounds.
+class Stats : public Sink {
+public:
+    void write(const Record& record) override;
+
+    long long getRounds() const;
+    long long getLossRounds() const;
+    long long getPhaseRounds(Phase phase) const;
+    double getMeanCwnd() const;
+    // Smallest cwnd with at least the given share of the rounds at or below it.
+    int getCwndPercentile(double share) const;
+
+    void print(std::ostream& os) const;
+
+private:
+    std::vector<long long> cwndCounts_;
+    long long phaseRounds_[PHASE_COUNT] = {};
+    long long rounds_ = 0;
+    long long lossRounds_ = 0;
+    long long cwndSum_ = 0;
+};
+
+// Writes the records of a trace as CSV, false if the input is not a trace.
+bool writeCsv(std::istream& is, std::ostream& os);
+
+} // namespace trace
+
+#endif // TRACE_HPP_INCLUDE
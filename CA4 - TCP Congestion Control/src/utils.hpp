@@ -1,17 +1,14 @@
 #ifndef UTILS_HPP_INCLUDE
 #define UTILS_HPP_INCLUDE
 
-#include <chrono>
-#include <random>
 #include <cmath>
 
+#include "philox.hpp"
+
 namespace utils {
 
-inline int randInt(int first, int last) {
-    thread_local static const auto seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-    thread_local static std::mt19937 gen(static_cast<std::mt19937::result_type>(seed));
-    std::uniform_int_distribution<int> dist(first, last);
-    return dist(gen);
+inline int randInt(Philox& gen, int first, int last) {
+    return gen.uniformInt(first, last);
 }
 
 inline double expProb(int x, int first, int last) {
@@ -0,0 +1,49 @@
+#include "vegas.hpp"
+
+#include <algorithm>
+
+bool Vegas::onAck(Window& window, const AckEvent& ack) {
+    if (ack.acked == 0) return false;
+    if (ack.rtt > 0) {
+        if (baseRtt_ < 0 || ack.rtt < baseRtt_) {
+            baseRtt_ = ack.rtt;
+        }
+        if (roundMinRtt_ < 0 || ack.rtt < roundMinRtt_) {
+            roundMinRtt_ = ack.rtt;
+        }
+    }
+
+    if (ack.delivered < nextRoundDelivered_ || roundMinRtt_ < 0) {
+        if (window.cwnd < window.ssthresh) {
+            window.cwnd = std::min(window.cwnd + ack.acked, window.ssthresh);
+        }
+        return false;
+    }
+
+    // End of a round: every packet sent at its start is acknowledged.
+    nextRoundDelivered_ = ack.delivered + ack.inflight;
+    double queued = window.cwnd * (1.0 - static_cast<double>(baseRtt_) / roundMinRtt_);
+    roundMinRtt_ = -1;
+    if (window.cwnd < window.ssthresh) {
+        if (queued > GAMMA) {
+            window.cwnd = std::max(static_cast<int>(window.cwnd - queued) + 1, 2);
+            window.ssthresh = window.cwnd;
+        }
+        else {
+            window.cwnd = std::min(window.cwnd + ack.acked, window.ssthresh);
+        }
+    }
+    else if (queued > BETA) {
+        window.cwnd = std::max(window.cwnd - 1, 2);
+    }
+    else if (queued < ALPHA) {
+        ++window.cwnd;
+    }
+    return false;
+}
+
+void Vegas::onLoss(Window& window, LossEvent loss) {
+    window.ssthresh = std::max(window.cwnd / 2, 2);
+    window.cwnd = loss == LossEvent::timeout ? 1 : window.ssthresh;
+    roundMinRtt_ = -1;
+}
@@ -0,0 +1,25 @@
+#ifndef VEGAS_HPP_INCLUDE
+#define VEGAS_HPP_INCLUDE
+
+#include "congestion_ops.hpp"
+
+// TCP Vegas (Brakmo & Peterson): once per round the packets the flow keeps in
+// the queue are estimated as cwnd * (1 - baseRtt / rtt), and the window moves
+// by one packet to keep them between ALPHA and BETA. Slow start ends as soon
+// as more than GAMMA packets are queued. Losses are handled as in Reno.
+class Vegas {
+public:
+    bool onAck(Window& window, const AckEvent& ack);
+    void onLoss(Window& window, LossEvent loss);
+
+private:
+    static constexpr double ALPHA = 2.0;
+    static constexpr double BETA = 4.0;
+    static constexpr double GAMMA = 1.0;
+
+    long long baseRtt_ = -1;
+    long long roundMinRtt_ = -1;
+    long long nextRoundDelivered_ = 0;
+};
+
+#endif // VEGAS_HPP_INCLUDE
@@ -0,0 +1,66 @@
+#include "westwood.hpp"
+
+#include <algorithm>
+
+bool Westwood::onAck(Window& window, const AckEvent& ack) {
+    if (ack.rtt > 0) {
+        lastRtt_ = ack.rtt;
+        if (minRtt_ < 0 || ack.rtt < minRtt_) {
+            minRtt_ = ack.rtt;
+        }
+    }
+    // A duplicate ack still stands for a packet that left the network.
+    ackedInInterval_ += ack.acked == 0 ? 1 : ack.acked;
+    sample(ack.time);
+    if (ack.acked == 0) return false;
+
+    if (window.cwnd < window.ssthresh) {
+        window.cwnd = std::min(window.cwnd + ack.acked, window.ssthresh);
+        return false;
+    }
+    ackedInWindow_ += ack.acked;
+    while (ackedInWindow_ >= window.cwnd) {
+        ackedInWindow_ -= window.cwnd;
+        ++window.cwnd;
+    }
+    return false;
+}
+
+void Westwood::onLoss(Window& window, LossEvent loss) {
+    window.ssthresh = std::max(getBdp(), 2);
+    if (loss == LossEvent::timeout) {
+        window.cwnd = 1;
+    }
+    else {
+        window.cwnd = std::min(window.cwnd, window.ssthresh);
+    }
+    ackedInWindow_ = 0;
+}
+
+// Both filters are the 7/8 moving average of the Linux implementation.
+void Westwood::sample(long long now) {
+    if (intervalStart_ < 0) {
+        intervalStart_ = now;
+        ackedInInterval_ = 0;
+        return;
+    }
+    long long interval = now - intervalStart_;
+    if (interval < std::max(lastRtt_, MIN_INTERVAL)) return;
+
+    double rate = static_cast<double>(ackedInInterval_) * NS_PER_SEC / interval;
+    if (bandwidth_ == 0.0) {
+        rawBandwidth_ = rate;
+        bandwidth_ = rate;
+    }
+    else {
+        rawBandwidth_ = (7 * rawBandwidth_ + rate) / 8;
+        bandwidth_ = (7 * bandwidth_ + rawBandwidth_) / 8;
+    }
+    intervalStart_ = now;
+    ackedInInterval_ = 0;
+}
+
+int Westwood::getBdp() const {
+    if (minRtt_ < 0) return 0;
+    return static_cast<int>(bandwidth_ * minRtt_ / NS_PER_SEC);
+}
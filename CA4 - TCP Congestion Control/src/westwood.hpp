@@ -0,0 +1,30 @@
+#ifndef WESTWOOD_HPP_INCLUDE
+#define WESTWOOD_HPP_INCLUDE
+
+#include "congestion_ops.hpp"
+
+// TCP Westwood+ (Mascolo et al.): grows like Reno, but estimates the bandwidth
+// from the acked packets of every round and sets ssthresh to the estimated
+// bandwidth-delay product after a loss instead of halving the window.
+class Westwood {
+public:
+    bool onAck(Window& window, const AckEvent& ack);
+    void onLoss(Window& window, LossEvent loss);
+
+private:
+    // The samples are taken over at least a round trip and at least this long.
+    static constexpr long long MIN_INTERVAL = 50 * NS_PER_MS;
+
+    double bandwidth_ = 0.0;       // packets per second, filtered twice
+    double rawBandwidth_ = 0.0;
+    long long minRtt_ = -1;
+    long long lastRtt_ = 0;
+    long long intervalStart_ = -1;
+    int ackedInInterval_ = 0;
+    int ackedInWindow_ = 0;
+
+    void sample(long long now);
+    int getBdp() const;
+};
+
+#endif // WESTWOOD_HPP_INCLUDE
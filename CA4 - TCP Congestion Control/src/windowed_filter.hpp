@@ -0,0 +1,62 @@
+#ifndef WINDOWED_FILTER_HPP_INCLUDE
+#define WINDOWED_FILTER_HPP_INCLUDE
+
+#include <array>
+
+// Best value over the last N slots, where a slot is a round trip or a fixed
+// slice of time. The ring keeps the best value of every slot; an update is one
+// comparison against the slot and one against the cached best, and the ring is
+// only rescanned when the window moves to a new slot. Slots never go back.
+template <typename T, typename Better, int N>
+class WindowedFilter {
+public:
+    explicit WindowedFilter(T empty)
+        : empty_(empty) {
+        reset();
+    }
+
+    void reset() {
+        ring_.fill(empty_);
+        best_ = empty_;
+        slot_ = -1;
+    }
+
+    bool empty() const { return best_ == empty_; }
+    T get() const { return best_; }
+
+    void update(long long slot, T value) {
+        if (slot != slot_) {
+            advance(slot);
+        }
+        T& bucket = ring_[slot % N];
+        if (better_(value, bucket)) {
+            bucket = value;
+        }
+        if (better_(value, best_)) {
+            best_ = value;
+        }
+    }
+
+private:
+    std::array<T, N> ring_;
+    T empty_;
+    T best_;
+    long long slot_;
+    Better better_;
+
+    void advance(long long slot) {
+        long long first = slot - N + 1 > slot_ + 1 ? slot - N + 1 : slot_ + 1;
+        for (long long s = first; s <= slot; ++s) {
+            ring_[s % N] = empty_;
+        }
+        slot_ = slot;
+        best_ = empty_;
+        for (const T& value : ring_) {
+            if (better_(value, best_)) {
+                best_ = value;
+            }
+        }
+    }
+};
+
+#endif // WINDOWED_FILTER_HPP_INCLUDE